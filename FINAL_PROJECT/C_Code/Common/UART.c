@@ -24,6 +24,9 @@
  *    - `UART_sendString()`: Sends a string of characters via UART.
  *    - `UART_receiveString()`: Receives a string of characters via UART, terminated by a specific delimiter.
  *
+ * 4. Application Callback:
+ *    - `UART_setCallBack()`: Reports the bytes sent and received and the waits for a byte to the application.
+ *
  * Configuration:
  * The UART driver can be configured using the following parameters:
  * - Baud rate: Determines the speed of data transmission.
@@ -51,6 +54,12 @@
 #include <avr/io.h>
 #include "common_macros.h"
 
+/*
+ * Pointer to the application callback
+ *  1. Initialized to NULL_PTR.
+ *  2. Set by UART_setCallBack(), called on the events of UART_EventType.
+ */
+static void (*g_CallBackUART)(UART_EventType event, uint8 data) = NULL_PTR;
 
 void UART_Init(UART_Config *UART_configPtr)
 {
@@ -112,6 +121,10 @@ void UART_sendByte(const uint8 data)
 	 * the UDR register is not empty now
 	 */
 	UDR = data;
+	if(g_CallBackUART != NULL_PTR)
+	{
+		(*g_CallBackUART)(UART_EVENT_TX, data);
+	}
 
 	/************************* Another Method *************************
 	UDR = data;
@@ -126,6 +139,13 @@ void UART_sendByte(const uint8 data)
  */
 uint8 UART_recieveByte(void)
 {
+	uint8 data;
+
+	if(g_CallBackUART != NULL_PTR)
+	{
+		(*g_CallBackUART)(UART_EVENT_RX_WAIT, 0);
+	}
+
 	/**
 	 * Wait until the RXC flag (UART_RECEIVE_COMPLETE) is set in the UCSRA register.
 	 * The RXC flag indicates that there is data available in the
@@ -143,7 +163,12 @@ uint8 UART_recieveByte(void)
 	 * Read the received data from the Rx buffer (UDR)
 	 * The RXC flag will be cleared after read the data
 	 */
-    return UDR;
+	data = UDR;
+	if(g_CallBackUART != NULL_PTR)
+	{
+		(*g_CallBackUART)(UART_EVENT_RX, data);
+	}
+	return data;
 }
 
 /*
@@ -190,4 +215,12 @@ void UART_receiveString(uint8 *Str)
     Str[i] = '\0';
 }
 
+/*
+ * Description :
+ * Set the function called on the events of the driver, NULL_PTR for none.
+ */
+void UART_setCallBack(void(*a_ptr)(UART_EventType event, uint8 data))
+{
+	g_CallBackUART = a_ptr;
+}
 
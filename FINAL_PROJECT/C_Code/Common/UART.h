@@ -70,6 +70,14 @@ typedef struct {
     UART_STOP_BIT_TYPE stopSelect;          /* UART stop bit selection (1 or 2 bits) */
 } UART_Config;
 /***********************************************/
+/* UART Events reported to the application callback (UART_setCallBack) */
+typedef enum
+{
+    UART_EVENT_TX,        /* Byte written for sending, data: the byte */
+    UART_EVENT_RX_WAIT,   /* Reception waiting for a byte, the CPU only polls from here */
+    UART_EVENT_RX         /* Byte received, the wait is over, data: the byte */
+} UART_EventType;
+/***********************************************/
 
 /***********************************************/
 
@@ -110,4 +118,11 @@ void UART_sendString(const uint8 *Str);
  */
 void UART_receiveString(uint8 *Str); // Receive until #
 
+/*
+ * Description :
+ * Set the function called on the events of the driver (trace, idle time of the waits), NULL_PTR for none.
+ * It runs in the caller's context, inside UART_sendByte() and UART_recieveByte().
+ */
+void UART_setCallBack(void(*a_ptr)(UART_EventType event, uint8 data));
+
 #endif /* UART_H_ */
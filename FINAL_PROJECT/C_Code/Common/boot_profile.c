@@ -0,0 +1,92 @@
+/*
+ * boot_profile.c
+ *
+ *  Boot step stamps and their dump, see boot_profile.h.
+ */
+
+#include "boot_profile.h"
+#include "ecu_config.h"
+#include "timestamp.h"
+#include "UART.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint16 g_times[BOOT_NUM_OF_STEPS];          /* Time each step ended */
+static uint8 g_marked = 0;                         /* Bit set for every step marked */
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+static void BootProfile_send(uint8 data, uint8 *checksum)
+{
+	UART_sendByte(data);
+	*checksum += data;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void BootProfile_mark(BootProfile_StepType step)
+{
+	uint32 now;
+
+	if(g_marked & (1 << step))
+	{
+		return;
+	}
+	now = Timestamp_now();
+	g_times[step] = (now > 0xFFFF) ? 0xFFFF : (uint16)now;
+	g_marked |= (1 << step);
+}
+
+void BootProfile_waitSinceStart(uint16 counts)
+{
+	while(Timestamp_now() < counts)
+	{
+	}
+}
+
+void BootProfile_dump(void)
+{
+	uint8 step, count = 0, checksum = 0;
+
+	for(step = 0 ; step < BOOT_NUM_OF_STEPS ; step++)
+	{
+		if(g_marked & (1 << step))
+		{
+			count++;
+		}
+	}
+
+	UART_sendByte(BOOT_FRAME_START);
+	BootProfile_send(ECU_ID, &checksum);
+	BootProfile_send(count, &checksum);
+
+	for(step = 0 ; step < BOOT_NUM_OF_STEPS ; step++)
+	{
+		if(g_marked & (1 << step))
+		{
+			BootProfile_send(step, &checksum);
+			BootProfile_send((uint8)g_times[step], &checksum);
+			BootProfile_send((uint8)(g_times[step] >> 8), &checksum);
+		}
+	}
+	UART_sendByte(checksum);
+}
+
+void BootProfile_skipFrame(void)
+{
+	uint16 left;
+
+	(void)UART_recieveByte();                   /* ECU id */
+	left = UART_recieveByte();                  /* Steps */
+	left = left * 3 + 1;                        /* Identifier and time of each, checksum */
+	while(left != 0)
+	{
+		(void)UART_recieveByte();
+		left--;
+	}
+}
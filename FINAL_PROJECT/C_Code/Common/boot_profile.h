@@ -0,0 +1,82 @@
+/*
+ * boot_profile.h
+ *
+ *  Boot time profile: BootProfile_mark(step) stamps the end of a step of the start-up, the last
+ *  one (BOOT_READY) being the ECU ready for the PIN (prompt shown / waiting for the first byte).
+ *  The time is the Timer1 count of timestamp.h (F_CPU/1024, 128us) from the Timer1 start, the first
+ *  thing main() does: the C start-up before it (stack paint, .data copy, .bss clear) is not counted.
+ *  Only the first mark of a step is kept, so a step can be marked from code run again later.
+ *
+ *  Dump frame (all bytes after the start byte are in the checksum):
+ *    BOOT_FRAME_START, ECU id, step count,
+ *    per step marked: its identifier, then its time (2 bytes LE), checksum (8-bit sum)
+ */
+
+#ifndef BOOT_PROFILE_H_
+#define BOOT_PROFILE_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define BOOT_REQUEST                   'B'      /* Link byte asking for a dump */
+#define BOOT_FRAME_START               0x7A
+#define BOOT_FRAME_HEADER_SIZE         2        /* ECU id, step count, after the start byte */
+
+/* Timer1 counts (F_CPU/1024) of a time in ms, rounded up */
+#define BOOT_MS_TO_COUNTS(ms)          ((uint16)(((uint32)(ms) * (F_CPU / 1000UL) + 1023UL) / 1024UL))
+
+/*
+ * Steps: identifier, name for the decoder, ECU marking it ('B' for both).
+ * The list is the same on both ECUs, in the order they normally end.
+ */
+#define BOOT_STEPS(STEP)                                                                     \
+	STEP(BOOT_UART,     "uart",     'B')    /* UART up */                                      \
+	STEP(BOOT_KEYPAD,   "keypad",   'H')    /* Keypad scanned, the keys typed from here are queued */ \
+	STEP(BOOT_EEPROM,   "eeprom",   'C')    /* I2C up and the stored password read in RAM */   \
+	STEP(BOOT_DRIVERS,  "drivers",  'C')    /* Motor, door position, PIR, buzzer, PWM and ADC up */ \
+	STEP(BOOT_LCD,      "lcd",      'H')    /* LCD powered up and set in its mode */           \
+	STEP(BOOT_READY,    "ready",    'B')    /* Ready for the PIN */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+#define BOOT_ENUM_ENTRY(ID, NAME, ECU)   ID,
+typedef enum
+{
+	BOOT_STEPS(BOOT_ENUM_ENTRY)
+	BOOT_NUM_OF_STEPS
+} BootProfile_StepType;
+#undef BOOT_ENUM_ENTRY
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Stamp the end of a boot step, nothing if it was already marked.
+ */
+void BootProfile_mark(BootProfile_StepType step);
+
+/*
+ * Description :
+ * Wait until the given Timer1 counts passed since the Timer1 start: a power-up delay of a device
+ * started with the ECU, the time already spent by the other inits is not waited again.
+ */
+void BootProfile_waitSinceStart(uint16 counts);
+
+/*
+ * Description :
+ * Send the steps marked over the UART (see the frame above).
+ */
+void BootProfile_dump(void);
+
+/*
+ * Description :
+ * Read and drop a frame of the other ECU after its start byte was received.
+ */
+void BootProfile_skipFrame(void);
+
+#endif /* BOOT_PROFILE_H_ */
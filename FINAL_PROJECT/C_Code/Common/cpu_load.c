@@ -0,0 +1,207 @@
+/*
+ * cpu_load.c
+ *
+ *  Idle time accounting and its dump, see cpu_load.h.
+ */
+
+#include "cpu_load.h"
+#include "ecu_config.h"
+#include "timestamp.h"
+#include "UART.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint32 g_mark;                        /* Time accounted up to */
+static uint16 g_windowFill;                  /* Counts accounted in the current second */
+static uint16 g_windowIdle;                  /* Idle counts in the current second */
+static uint32 g_phaseIdle[ECU_PHASES];
+static uint32 g_phaseTotal[ECU_PHASES];
+static uint8 g_history[CPULOAD_HISTORY];     /* Load of the last seconds (%) */
+static uint8 g_historyHead = 0;              /* Next second written */
+static uint8 g_phase = 0;
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+/* Keep the load of the second just over */
+static void CpuLoad_closeWindow(void)
+{
+	g_history[g_historyHead] = (uint8)(100 - ((uint32)g_windowIdle * 100) / CPULOAD_WINDOW);
+	g_historyHead = (g_historyHead + 1) & (CPULOAD_HISTORY - 1);
+	g_windowFill = 0;
+	g_windowIdle = 0;
+}
+
+/* Add the time since the last call to the current phase (and seconds) as idle or busy */
+static void CpuLoad_account(uint8 idle)
+{
+	uint32 now = Timestamp_now();
+	uint32 elapsed = now - g_mark;
+	uint32 part;
+
+	/* Never back in time, even if a period was missed (its interrupt held off too long) */
+	if((sint32)elapsed < 0)
+	{
+		return;
+	}
+	g_mark = now;
+	g_phaseTotal[g_phase] += elapsed;
+	if(idle)
+	{
+		g_phaseIdle[g_phase] += elapsed;
+	}
+
+	/* Fill the current second, the span may end it and the next ones (a long wait) */
+	part = CPULOAD_WINDOW - g_windowFill;
+	if(elapsed < part)
+	{
+		g_windowFill += (uint16)elapsed;
+		if(idle)
+		{
+			g_windowIdle += (uint16)elapsed;
+		}
+		return;
+	}
+	if(idle)
+	{
+		g_windowIdle += (uint16)part;
+	}
+	CpuLoad_closeWindow();
+	elapsed -= part;
+
+	/* Whole seconds of the span, all idle or all busy (the ones before the last CPULOAD_HISTORY don't show) */
+	part = elapsed / CPULOAD_WINDOW;
+	elapsed -= part * CPULOAD_WINDOW;
+	if(part > CPULOAD_HISTORY)
+	{
+		part = CPULOAD_HISTORY;
+	}
+	while(part != 0)
+	{
+		g_windowIdle = idle ? CPULOAD_WINDOW : 0;
+		CpuLoad_closeWindow();
+		part--;
+	}
+
+	/* The rest of the span starts the new second */
+	g_windowFill = (uint16)elapsed;
+	g_windowIdle = idle ? (uint16)elapsed : 0;
+}
+
+static void CpuLoad_send(uint8 data, uint8 *checksum)
+{
+	UART_sendByte(data);
+	*checksum += data;
+}
+
+static void CpuLoad_send32(uint32 data, uint8 *checksum)
+{
+	uint8 index;
+
+	for(index = 0 ; index < 4 ; index++)
+	{
+		CpuLoad_send((uint8)data, checksum);
+		data >>= 8;
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void CpuLoad_init(void)
+{
+	uint8 index;
+
+	for(index = 0 ; index < CPULOAD_HISTORY ; index++)
+	{
+		g_history[index] = CPULOAD_NO_LOAD;
+	}
+	for(index = 0 ; index < ECU_PHASES ; index++)
+	{
+		g_phaseIdle[index] = 0;
+		g_phaseTotal[index] = 0;
+	}
+	g_historyHead = 0;
+	g_phase = 0;
+	g_mark = Timestamp_now();
+	g_windowFill = 0;
+	g_windowIdle = 0;
+}
+
+void CpuLoad_idleBegin(void)
+{
+	CpuLoad_account(FALSE);
+}
+
+void CpuLoad_idleEnd(void)
+{
+	CpuLoad_account(TRUE);
+}
+
+void CpuLoad_setPhase(uint8 phase)
+{
+	if(phase >= ECU_PHASES)
+	{
+		phase = ECU_PHASES - 1;
+	}
+	if(phase != g_phase)
+	{
+		CpuLoad_account(FALSE);
+		g_phase = phase;
+	}
+}
+
+void CpuLoad_dump(void)
+{
+	uint8 index, peak = 0, checksum = 0;
+
+	CpuLoad_account(FALSE);
+	for(index = 0 ; index < CPULOAD_HISTORY ; index++)
+	{
+		if((g_history[index] != CPULOAD_NO_LOAD) && (g_history[index] > peak))
+		{
+			peak = g_history[index];
+		}
+	}
+
+	UART_sendByte(CPULOAD_FRAME_START);
+	CpuLoad_send(ECU_ID, &checksum);
+	CpuLoad_send(CPULOAD_HISTORY, &checksum);
+	CpuLoad_send(ECU_PHASES, &checksum);
+	CpuLoad_send(peak, &checksum);
+
+	/* Oldest first */
+	for(index = 0 ; index < CPULOAD_HISTORY ; index++)
+	{
+		CpuLoad_send(g_history[(g_historyHead + index) & (CPULOAD_HISTORY - 1)], &checksum);
+	}
+	for(index = 0 ; index < ECU_PHASES ; index++)
+	{
+		CpuLoad_send32(g_phaseIdle[index], &checksum);
+		CpuLoad_send32(g_phaseTotal[index], &checksum);
+		g_phaseIdle[index] = 0;
+		g_phaseTotal[index] = 0;
+	}
+	UART_sendByte(checksum);
+
+	/* The dump itself is not counted in the next sums */
+	g_mark = Timestamp_now();
+}
+
+void CpuLoad_skipFrame(void)
+{
+	uint16 left;
+
+	(void)UART_recieveByte();                   /* ECU id */
+	left = UART_recieveByte();                  /* History */
+	left += (uint16)UART_recieveByte() * 8;     /* Idle and total counts of every phase */
+	left += 1 + 1;                              /* Peak, checksum */
+	while(left != 0)
+	{
+		(void)UART_recieveByte();
+		left--;
+	}
+}
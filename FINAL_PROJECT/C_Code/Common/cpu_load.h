@@ -0,0 +1,73 @@
+/*
+ * cpu_load.h
+ *
+ *  CPU load of the ECU from the time it spends idle: the application marks where it waits
+ *  (CpuLoad_idleBegin/CpuLoad_idleEnd around a sleep or a wait loop), every other moment counts
+ *  as busy. The time is counted in Timer1 counts (F_CPU/1024, 128us) of timestamp.h, so an
+ *  interrupt served while the CPU waits counts as idle and a span shorter than one count is only
+ *  right on average.
+ *
+ *  The time accounted is cut in windows of CPULOAD_WINDOW counts (1s): a span longer than the rest
+ *  of the window (a long wait for a key) closes it and fills the next ones. The last CPULOAD_HISTORY
+ *  windows give the load per second and the rolling peak. The busy and total time are also summed
+ *  per application phase (CpuLoad_setPhase) since the last dump.
+ *  The number of phases (ECU_PHASES) comes from ecu_config.h of the ECU built.
+ *
+ *  Dump frame (all bytes after the start byte are in the checksum):
+ *    CPULOAD_FRAME_START, ECU id, history length, phase count, rolling peak (%),
+ *    load per second (%, oldest first, CPULOAD_NO_LOAD before the first ones),
+ *    per phase: idle counts, total counts (4 bytes LE each), checksum (8-bit sum)
+ */
+
+#ifndef CPU_LOAD_H_
+#define CPU_LOAD_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define CPULOAD_WINDOW                 (F_CPU / 1024)   /* Counts in one second */
+#define CPULOAD_HISTORY                16       /* Seconds kept, must be a power of 2 */
+#define CPULOAD_NO_LOAD                0xFF
+
+#define CPULOAD_REQUEST                'U'      /* Link byte asking for a dump */
+#define CPULOAD_FRAME_START            0x7B
+#define CPULOAD_FRAME_HEADER_SIZE      4        /* ECU id, history length, phase count, peak, after the start byte */
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Clear the measurements, the CPU counts as busy in phase 0 from now on.
+ */
+void CpuLoad_init(void);
+
+/*
+ * Description :
+ * The CPU starts / stops waiting, from the main loop only (no nesting).
+ */
+void CpuLoad_idleBegin(void);
+void CpuLoad_idleEnd(void);
+
+/*
+ * Description :
+ * The time from now on belongs to the given phase (phases above ECU_PHASES - 1 share the last one).
+ */
+void CpuLoad_setPhase(uint8 phase);
+
+/*
+ * Description :
+ * Send the measurements over the UART (see the frame above) and clear the phase sums.
+ */
+void CpuLoad_dump(void);
+
+/*
+ * Description :
+ * Read and drop a frame of the other ECU after its start byte was received.
+ */
+void CpuLoad_skipFrame(void);
+
+#endif /* CPU_LOAD_H_ */
@@ -288,6 +288,69 @@ void GPIO_writePort(uint8 port_num, uint8 value)
 	}
 }
 
+/*
+ * Description :
+ * Write the value on the pins selected by the mask only, the other pins keep their state.
+ * All the selected pins change with one store and the update is safe against interrupts.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writePortMasked(uint8 port_num, uint8 mask, uint8 value)
+{
+	if((port_num >= NUM_OF_PORTS))
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		switch (port_num)
+		{
+			case PORTA_ID:
+				GPIO_WRITE_PORT_MASKED(PORTA_ID, mask, value);
+				break;
+			case PORTB_ID:
+				GPIO_WRITE_PORT_MASKED(PORTB_ID, mask, value);
+				break;
+			case PORTC_ID:
+				GPIO_WRITE_PORT_MASKED(PORTC_ID, mask, value);
+				break;
+			case PORTD_ID:
+				GPIO_WRITE_PORT_MASKED(PORTD_ID, mask, value);
+				break;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Toggle the pins selected by the mask with one store, safe against interrupts.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_togglePortMasked(uint8 port_num, uint8 mask)
+{
+	if((port_num >= NUM_OF_PORTS))
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		switch (port_num)
+		{
+			case PORTA_ID:
+				GPIO_TOGGLE_PINS_ATOMIC(PORTA_ID, mask);
+				break;
+			case PORTB_ID:
+				GPIO_TOGGLE_PINS_ATOMIC(PORTB_ID, mask);
+				break;
+			case PORTC_ID:
+				GPIO_TOGGLE_PINS_ATOMIC(PORTC_ID, mask);
+				break;
+			case PORTD_ID:
+				GPIO_TOGGLE_PINS_ATOMIC(PORTD_ID, mask);
+				break;
+		}
+	}
+}
+
 /*
  * Description :
  * Read and return the value of the required port.
@@ -0,0 +1,200 @@
+ /******************************************************************************
+ *
+ * Module: GPIO
+ *
+ * File Name: gpio.h
+ *
+ * Description: Header file for the AVR GPIO driver
+ *
+ * Author: amr mohamed
+ *
+ *******************************************************************************/
+
+#ifndef GPIO_H_
+#define GPIO_H_
+
+#include "std_types.h"
+#include "common_macros.h"
+#include <avr/io.h>
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define NUM_OF_PORTS           4
+#define NUM_OF_PINS_PER_PORT   8
+
+#define PORTA_ID               0
+#define PORTB_ID               1
+#define PORTC_ID               2
+#define PORTD_ID               3
+
+#define PIN0_ID                0
+#define PIN1_ID                1
+#define PIN2_ID                2
+#define PIN3_ID                3
+#define PIN4_ID                4
+#define PIN5_ID                5
+#define PIN6_ID                6
+#define PIN7_ID                7
+
+/*******************************************************************************
+ *                         Compile-time Pin Access                             *
+ *******************************************************************************/
+/*
+ * Registers of a port selected by the preprocessor from its ID (PORTA_ID..PORTD_ID).
+ * Any other ID expands to an undefined name, so it fails the build.
+ */
+#define GPIO_DDR_REG(PORT_ID)          GPIO_CONCAT(GPIO_DDR_REG_, PORT_ID)
+#define GPIO_PORT_REG(PORT_ID)         GPIO_CONCAT(GPIO_PORT_REG_, PORT_ID)
+#define GPIO_PIN_REG(PORT_ID)          GPIO_CONCAT(GPIO_PIN_REG_, PORT_ID)
+
+#define GPIO_CONCAT(A,B)               GPIO_CONCAT_(A,B)   /* Expand the ID before pasting it */
+#define GPIO_CONCAT_(A,B)              A##B
+
+#define GPIO_DDR_REG_0                 DDRA
+#define GPIO_DDR_REG_1                 DDRB
+#define GPIO_DDR_REG_2                 DDRC
+#define GPIO_DDR_REG_3                 DDRD
+#define GPIO_PORT_REG_0                PORTA
+#define GPIO_PORT_REG_1                PORTB
+#define GPIO_PORT_REG_2                PORTC
+#define GPIO_PORT_REG_3                PORTD
+#define GPIO_PIN_REG_0                 PINA
+#define GPIO_PIN_REG_1                 PINB
+#define GPIO_PIN_REG_2                 PINC
+#define GPIO_PIN_REG_3                 PIND
+
+/*
+ * Fails the build if the pin number is not a constant below NUM_OF_PINS_PER_PORT
+ * (a bit-field width must be a non-negative integer constant).
+ */
+#define GPIO_PIN_CHECK(PIN_ID) \
+	((void)sizeof(struct { int gpio_invalid_pin : (((PIN_ID) < NUM_OF_PINS_PER_PORT) ? 1 : -1); }))
+
+/*
+ * Zero-overhead versions of the functions below for pins known at compile time
+ * (e.g. the pins configured in the drivers headers).
+ * Port and pin are resolved by the compiler, so with optimization each pin access
+ * is a single sbi/cbi/sbic/sbis instruction instead of a call, a check and a switch.
+ */
+#define GPIO_SETUP_PIN_DIRECTION(PORT_ID,PIN_ID,DIRECTION) \
+	(GPIO_PIN_CHECK(PIN_ID), \
+	 ((DIRECTION) == PIN_OUTPUT) ? SET_BIT(GPIO_DDR_REG(PORT_ID),PIN_ID) : CLEAR_BIT(GPIO_DDR_REG(PORT_ID),PIN_ID))
+
+#define GPIO_WRITE_PIN(PORT_ID,PIN_ID,VALUE) \
+	(GPIO_PIN_CHECK(PIN_ID), \
+	 ((VALUE) == LOGIC_HIGH) ? SET_BIT(GPIO_PORT_REG(PORT_ID),PIN_ID) : CLEAR_BIT(GPIO_PORT_REG(PORT_ID),PIN_ID))
+
+#define GPIO_READ_PIN(PORT_ID,PIN_ID) \
+	(GPIO_PIN_CHECK(PIN_ID), \
+	 BIT_IS_SET(GPIO_PIN_REG(PORT_ID),PIN_ID) ? LOGIC_HIGH : LOGIC_LOW)
+
+#define GPIO_SETUP_PORT_DIRECTION(PORT_ID,DIRECTION)   (GPIO_DDR_REG(PORT_ID) = (DIRECTION))
+#define GPIO_WRITE_PORT(PORT_ID,VALUE)                 (GPIO_PORT_REG(PORT_ID) = (VALUE))
+#define GPIO_READ_PORT(PORT_ID)                        (GPIO_PIN_REG(PORT_ID))
+
+/*
+ * Update several pins of a port with one store, the pins in MASK take their value from VALUE
+ * and the other pins keep their state. The read-modify-write runs with interrupts disabled,
+ * so it is safe against ISRs writing other pins of the same port.
+ */
+#define GPIO_WRITE_PORT_MASKED(PORT_ID,MASK,VALUE) \
+	do { \
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) \
+		{ \
+			GPIO_PORT_REG(PORT_ID) = (GPIO_PORT_REG(PORT_ID) & ~(MASK)) | ((VALUE) & (MASK)); \
+		} \
+	} while(0)
+
+#define GPIO_SET_PINS_ATOMIC(PORT_ID,MASK)             GPIO_WRITE_PORT_MASKED(PORT_ID,MASK,0xFF)
+#define GPIO_CLEAR_PINS_ATOMIC(PORT_ID,MASK)           GPIO_WRITE_PORT_MASKED(PORT_ID,MASK,0x00)
+
+#define GPIO_TOGGLE_PINS_ATOMIC(PORT_ID,MASK) \
+	do { \
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) \
+		{ \
+			GPIO_PORT_REG(PORT_ID) ^= (MASK); \
+		} \
+	} while(0)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum
+{
+	PIN_INPUT,PIN_OUTPUT
+}GPIO_PinDirectionType;
+
+typedef enum
+{
+	PORT_INPUT,PORT_OUTPUT=0xFF
+}GPIO_PortDirectionType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the direction of the required pin input/output.
+ * If the input port number or pin number are not correct, The function will not handle the request.
+ */
+void GPIO_setupPinDirection(uint8 port_num, uint8 pin_num, GPIO_PinDirectionType direction);
+
+/*
+ * Description :
+ * Write the value Logic High or Logic Low on the required pin.
+ * If the input port number or pin number are not correct, The function will not handle the request.
+ * If the pin is input, this function will enable/disable the internal pull-up resistor.
+ */
+void GPIO_writePin(uint8 port_num, uint8 pin_num, uint8 value);
+
+/*
+ * Description :
+ * Read and return the value for the required pin, it should be Logic High or Logic Low.
+ * If the input port number or pin number are not correct, The function will return Logic Low.
+ */
+uint8 GPIO_readPin(uint8 port_num, uint8 pin_num);
+
+/*
+ * Description :
+ * Setup the direction of the required port all pins input/output.
+ * If the direction value is PORT_INPUT all pins in this port should be input pins.
+ * If the direction value is PORT_OUTPUT all pins in this port should be output pins.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_setupPortDirection(uint8 port_num, GPIO_PortDirectionType direction);
+
+/*
+ * Description :
+ * Write the value on the required port.
+ * If any pin in the port is output pin the value will be written.
+ * If any pin in the port is input pin this will activate/deactivate the internal pull-up resistor.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writePort(uint8 port_num, uint8 value);
+
+/*
+ * Description :
+ * Write the value on the pins selected by the mask only, the other pins keep their state.
+ * All the selected pins change with one store and the update is safe against interrupts.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writePortMasked(uint8 port_num, uint8 mask, uint8 value);
+
+/*
+ * Description :
+ * Toggle the pins selected by the mask with one store, safe against interrupts.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_togglePortMasked(uint8 port_num, uint8 mask);
+
+/*
+ * Description :
+ * Read and return the value of the required port.
+ * If the input port number is not correct, The function will return ZERO value.
+ */
+uint8 GPIO_readPort(uint8 port_num);
+
+#endif /* GPIO_H_ */
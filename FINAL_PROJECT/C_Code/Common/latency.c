@@ -0,0 +1,185 @@
+/*
+ * latency.c
+ *
+ *  Latency histograms and their dump, see latency.h.
+ */
+
+#include "latency.h"
+#include "ecu_config.h"
+#include "timestamp.h"
+#include "UART.h"
+
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define LATENCY_COUNT                  (ECU_LATENCY_LAST - ECU_LATENCY_FIRST + 1)
+#define LATENCY_INDEX(id)              ((uint8)((id) - ECU_LATENCY_FIRST))
+#define LATENCY_MEASURED(id)           (LATENCY_INDEX(id) < LATENCY_COUNT)   /* Measured on this ECU */
+
+/* ECU_LATENCY_FIRST..ECU_LATENCY_LAST are enum values (no #if), 1 to 8 histograms: one bit each in g_running */
+typedef char Latency_countCheck[((LATENCY_COUNT >= 1) && (LATENCY_COUNT <= 8)) ? 1 : -1];
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint16 g_buckets[LATENCY_COUNT][LATENCY_BUCKETS];
+static uint32 g_starts[LATENCY_COUNT];             /* Time an operation started */
+static volatile uint8 g_running = 0;               /* Bit set for every operation started */
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+static uint8 Latency_bucketOf(uint32 counts)
+{
+	uint8 bucket = 0;
+
+	while((counts != 0) && (bucket < (LATENCY_BUCKETS - 1)))
+	{
+		counts >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+static void Latency_send(uint8 data, uint8 *checksum)
+{
+	UART_sendByte(data);
+	*checksum += data;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Latency_init(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_running = 0;
+	}
+	Latency_reset();
+}
+
+void Latency_start(Latency_IdType id)
+{
+	if(!LATENCY_MEASURED(id))
+	{
+		return;
+	}
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_starts[LATENCY_INDEX(id)] = Timestamp_now();
+		g_running |= (1 << LATENCY_INDEX(id));
+	}
+}
+
+void Latency_startFrom(Latency_IdType id, Latency_IdType from)
+{
+	if(!LATENCY_MEASURED(id) || !LATENCY_MEASURED(from))
+	{
+		return;
+	}
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if(g_running & (1 << LATENCY_INDEX(from)))
+		{
+			g_starts[LATENCY_INDEX(id)] = g_starts[LATENCY_INDEX(from)];
+			g_running |= (1 << LATENCY_INDEX(id));
+		}
+	}
+}
+
+void Latency_cancel(Latency_IdType id)
+{
+	if(!LATENCY_MEASURED(id))
+	{
+		return;
+	}
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_running &= ~(1 << LATENCY_INDEX(id));
+	}
+}
+
+void Latency_stop(Latency_IdType id)
+{
+	uint16 *bucket;
+
+	if(!LATENCY_MEASURED(id))
+	{
+		return;
+	}
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if(g_running & (1 << LATENCY_INDEX(id)))
+		{
+			g_running &= ~(1 << LATENCY_INDEX(id));
+			bucket = &g_buckets[LATENCY_INDEX(id)][Latency_bucketOf(Timestamp_now() - g_starts[LATENCY_INDEX(id)])];
+			if(*bucket < 0xFFFF)
+			{
+				(*bucket)++;
+			}
+		}
+	}
+}
+
+void Latency_dump(void)
+{
+	uint8 id, bucket, checksum = 0;
+	uint16 counter;
+
+	UART_sendByte(LATENCY_FRAME_START);
+	Latency_send(ECU_ID, &checksum);
+	Latency_send(LATENCY_COUNT, &checksum);
+	Latency_send(LATENCY_BUCKETS, &checksum);
+
+	for(id = ECU_LATENCY_FIRST ; id <= ECU_LATENCY_LAST ; id++)
+	{
+		Latency_send(id, &checksum);
+		for(bucket = 0 ; bucket < LATENCY_BUCKETS ; bucket++)
+		{
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				counter = g_buckets[LATENCY_INDEX(id)][bucket];
+			}
+			Latency_send((uint8)counter, &checksum);
+			Latency_send((uint8)(counter >> 8), &checksum);
+		}
+	}
+	UART_sendByte(checksum);
+}
+
+void Latency_reset(void)
+{
+	uint8 index, bucket;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for(index = 0 ; index < LATENCY_COUNT ; index++)
+		{
+			for(bucket = 0 ; bucket < LATENCY_BUCKETS ; bucket++)
+			{
+				g_buckets[index][bucket] = 0;
+			}
+		}
+	}
+}
+
+void Latency_skipFrame(void)
+{
+	uint16 left;
+	uint8 buckets;
+
+	(void)UART_recieveByte();                   /* ECU id */
+	left = UART_recieveByte();                  /* Histograms */
+	buckets = UART_recieveByte();
+	left = left * (1 + 2 * (uint16)buckets) + 1;  /* Identifier and counters of each, checksum */
+	while(left != 0)
+	{
+		(void)UART_recieveByte();
+		left--;
+	}
+}
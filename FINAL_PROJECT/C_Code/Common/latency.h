@@ -0,0 +1,107 @@
+/*
+ * latency.h
+ *
+ *  End-to-end latency histograms of the user-visible operations, kept in SRAM.
+ *
+ *  Latency_start(id) stamps the beginning of an operation, Latency_stop(id) adds the time passed
+ *  to the histogram of that operation. The time is counted in Timer1 counts (F_CPU/1024, 128us)
+ *  of timestamp.h. A latency of N counts goes
+ *  in bucket 0 when N is 0, else in the bucket of the bit length of N (bucket b holds 2^(b-1)..2^b - 1
+ *  counts), the last bucket holds everything longer.
+ *  The histograms measured (ECU_LATENCY_FIRST..ECU_LATENCY_LAST) come from ecu_config.h of the ECU built.
+ *
+ *  Dump frame (all bytes after the start byte are in the checksum):
+ *    LATENCY_FRAME_START, ECU id, histogram count, bucket count,
+ *    per histogram: its identifier, then the bucket counters (2 bytes LE each), checksum (8-bit sum)
+ */
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define LATENCY_BUCKETS                18       /* Last bucket: 2^16 counts (8.4s) and more */
+
+#define LATENCY_REQUEST                'L'      /* Link byte asking for a dump */
+#define LATENCY_RESET                  'R'      /* Link byte clearing the histograms */
+#define LATENCY_FRAME_START            0x7D
+#define LATENCY_FRAME_HEADER_SIZE      3        /* ECU id, histogram count, bucket count, after the start byte */
+
+/*
+ * Histograms: identifier, name for the decoder, ECU measuring it.
+ * The list is the same on both ECUs, the ones of an ECU follow each other.
+ */
+#define LATENCY_HISTOGRAMS(HISTOGRAM)                                                        \
+	HISTOGRAM(LATENCY_KEY_ECHO,      "key-echo",      'H')    /* Key press taken by the application to its '*' on the LCD */ \
+	HISTOGRAM(LATENCY_AUTH_VERDICT,  "auth-verdict",  'H')    /* '=' press to the answer of the Control ECU */ \
+	HISTOGRAM(LATENCY_AUTH_MOTOR,    "auth-motor",    'C')    /* Password accepted to the motor opening the door */ \
+	HISTOGRAM(LATENCY_CLEAR_CLOSE,   "clear-close",   'C')    /* PIR clear (door open) to the motor closing the door */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+#define LATENCY_ENUM_ENTRY(ID, NAME, ECU)   ID,
+typedef enum
+{
+	LATENCY_HISTOGRAMS(LATENCY_ENUM_ENTRY)
+	LATENCY_NUM_OF_HISTOGRAMS
+} Latency_IdType;
+#undef LATENCY_ENUM_ENTRY
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Clear the histograms and forget the operations started.
+ */
+void Latency_init(void);
+
+/*
+ * Description :
+ * Stamp the beginning of an operation (a new start replaces the previous one), safe from the ISRs.
+ * This and the calls below do nothing for a histogram not measured on this ECU.
+ */
+void Latency_start(Latency_IdType id);
+
+/*
+ * Description :
+ * Start an operation at the time another one started, nothing if that one is not running.
+ */
+void Latency_startFrom(Latency_IdType id, Latency_IdType from);
+
+/*
+ * Description :
+ * Forget a started operation.
+ */
+void Latency_cancel(Latency_IdType id);
+
+/*
+ * Description :
+ * End an operation and count its latency, nothing if it was not started.
+ */
+void Latency_stop(Latency_IdType id);
+
+/*
+ * Description :
+ * Send the histograms over the UART (see the frame above).
+ */
+void Latency_dump(void);
+
+/*
+ * Description :
+ * Clear the histograms, the operations started stay running.
+ */
+void Latency_reset(void);
+
+/*
+ * Description :
+ * Read and drop a frame of the other ECU after its start byte was received.
+ */
+void Latency_skipFrame(void);
+
+#endif /* LATENCY_H_ */
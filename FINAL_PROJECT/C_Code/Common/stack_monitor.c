@@ -0,0 +1,147 @@
+/*
+ * stack_monitor.c
+ *
+ *  Stack painting and its high-water mark scan, see stack_monitor.h.
+ */
+
+#include "stack_monitor.h"
+#include "ecu_config.h"
+#include "trace.h"
+#include "UART.h"
+
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                           Linker Symbols                                    *
+ *******************************************************************************/
+extern uint8 __data_start;                   /* First byte of the RAM */
+extern uint8 _end;                           /* First byte after the variables */
+extern uint8 __stack;                        /* Top of the stack, last byte of the RAM */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint8 *volatile g_lowest;             /* Deepest stack byte found used */
+static uint8 *g_cursor;                      /* Next byte scanned, only moved by StackMonitor_check() */
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+/*
+ * Paint the stack area, run from .init1 right after the reset: no stack, no zero register yet,
+ * so only registers are used. Never called.
+ */
+void StackMonitor_paint(void) __attribute__((naked, used, section(".init1")));
+void StackMonitor_paint(void)
+{
+	__asm__ __volatile__(
+		"    ldi r30, lo8(_end)       \n"
+		"    ldi r31, hi8(_end)       \n"
+		"    ldi r24, %0              \n"
+		"    ldi r25, hi8(__stack)    \n"
+		"    rjmp 2f                  \n"
+		"1:  st Z+, r24               \n"
+		"2:  cpi r30, lo8(__stack)    \n"
+		"    cpc r31, r25             \n"
+		"    brlo 1b                  \n"
+		"    breq 1b                  \n"
+		:: "M" (STACKMON_PAINT));
+}
+
+/*
+ * Record a new deepest point, with interrupts disabled: the scan restarts from the bottom (the
+ * stack can leave holes of paint in what it used)
+ */
+static void StackMonitor_record(uint8 *lowest)
+{
+	g_lowest = lowest;
+	g_cursor = &_end;
+	/* Less than 2048 bytes of RAM above the variables, the units fit a byte */
+	TRACE(TRACE_STACK, (uint16)(lowest - &_end) / STACKMON_TRACE_UNIT);
+}
+
+static void StackMonitor_send16(uint16 data, uint8 *checksum)
+{
+	UART_sendByte((uint8)data);
+	UART_sendByte((uint8)(data >> 8));
+	*checksum += (uint8)data + (uint8)(data >> 8);
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void StackMonitor_init(void)
+{
+	g_lowest = &__stack + 1;
+	g_cursor = &_end;
+}
+
+void StackMonitor_check(void)
+{
+	uint8 bytes = ECU_STACKMON_SCAN_STEP;
+
+	while(bytes != 0)
+	{
+		if(g_cursor >= g_lowest)
+		{
+			g_cursor = &_end;             /* Nothing deeper, start again from the bottom */
+			return;
+		}
+		if(*g_cursor != STACKMON_PAINT)
+		{
+			StackMonitor_record(g_cursor);
+			return;
+		}
+		g_cursor++;
+		bytes--;
+	}
+}
+
+uint16 StackMonitor_unused(void)
+{
+	uint8 *byte = &_end;
+	uint16 unused;
+
+	/* One pass from the bottom on its own cursor, the first byte found used is the deepest */
+	while((byte <= &__stack) && (*byte == STACKMON_PAINT))
+	{
+		byte++;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if(byte < g_lowest)
+		{
+			StackMonitor_record(byte);
+		}
+		unused = g_lowest - &_end;
+	}
+	return unused;
+}
+
+void StackMonitor_dump(void)
+{
+	uint16 unused = StackMonitor_unused();
+	uint8 checksum = ECU_ID;
+
+	UART_sendByte(STACKMON_FRAME_START);
+	UART_sendByte(ECU_ID);
+	StackMonitor_send16(&__stack + 1 - &__data_start, &checksum);
+	StackMonitor_send16(&_end - &__data_start, &checksum);
+	StackMonitor_send16(&__stack + 1 - &_end, &checksum);
+	StackMonitor_send16(unused, &checksum);
+	UART_sendByte(checksum);
+}
+
+void StackMonitor_skipFrame(void)
+{
+	uint8 left = STACKMON_FRAME_SIZE + 1;     /* Checksum */
+
+	while(left != 0)
+	{
+		(void)UART_recieveByte();
+		left--;
+	}
+}
@@ -0,0 +1,69 @@
+/*
+ * stack_monitor.h
+ *
+ *  Stack high-water mark: before the C runtime starts (.init1) the RAM between the end of the
+ *  variables (_end) and the top of the stack (__stack) is painted with STACKMON_PAINT. The stack
+ *  grows down into it and the interrupts use it too, so the lowest byte not holding the paint
+ *  anymore is the deepest the stack has ever been, the paint left below it is the margin.
+ *
+ *  StackMonitor_check() scans ECU_STACKMON_SCAN_STEP bytes of the paint (ecu_config.h) from the
+ *  Timer1 period callback, so the scan goes on while the main loop waits for a key or a byte (a full
+ *  scan is spread over many periods). A new deepest point is recorded as a TRACE_STACK event, with
+ *  the bytes never used in STACKMON_TRACE_UNIT units. StackMonitor_unused() scans all the paint at
+ *  once, for the dump.
+ *
+ *  Dump frame (all bytes after the start byte are in the checksum):
+ *    STACKMON_FRAME_START, ECU id, RAM size, variables (.data + .bss + .noinit),
+ *    room left for the stack at boot, bytes never used since (2 bytes LE each), checksum (8-bit sum)
+ */
+
+#ifndef STACK_MONITOR_H_
+#define STACK_MONITOR_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define STACKMON_PAINT                 0xC5
+#define STACKMON_TRACE_UNIT            8        /* Bytes per unit of the TRACE_STACK argument */
+
+#define STACKMON_REQUEST               'M'      /* Link byte asking for a dump */
+#define STACKMON_FRAME_START           0x7C
+#define STACKMON_FRAME_SIZE            9        /* ECU id, 4 sizes (2 bytes each), after the start byte */
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start the scan from the end of the variables, the paint is laid before main().
+ */
+void StackMonitor_init(void);
+
+/*
+ * Description :
+ * Scan the next part of the paint, from the Timer1 period callback (interrupt context).
+ */
+void StackMonitor_check(void);
+
+/*
+ * Description :
+ * Scan all the paint left and return the bytes of stack never used since the reset.
+ */
+uint16 StackMonitor_unused(void);
+
+/*
+ * Description :
+ * Send the RAM figures over the UART (see the frame above).
+ */
+void StackMonitor_dump(void);
+
+/*
+ * Description :
+ * Read and drop a frame of the other ECU after its start byte was received.
+ */
+void StackMonitor_skipFrame(void);
+
+#endif /* STACK_MONITOR_H_ */
@@ -0,0 +1,45 @@
+/*
+ * timestamp.c
+ *
+ *  Timer1 based time of the measurement modules, see timestamp.h.
+ */
+
+#include "timestamp.h"
+#include "ecu_config.h"
+#include "common_macros.h"
+
+#include <avr/io.h>
+#include <util/atomic.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static volatile uint32 g_periodBase = 0;           /* Counts of the Timer1 periods passed */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Timestamp_period(void)
+{
+	g_periodBase += (uint32)ECU_TIMESTAMP_TOP + 1;
+}
+
+uint32 Timestamp_now(void)
+{
+	uint16 count;
+	uint32 now;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		count = TCNT1;
+		now = g_periodBase + count;
+
+		/* The period ended but its interrupt has not run yet */
+		if(BIT_IS_SET(TIFR, ECU_TIMESTAMP_PERIOD_FLAG) && (count < (ECU_TIMESTAMP_TOP / 2)))
+		{
+			now += (uint32)ECU_TIMESTAMP_TOP + 1;
+		}
+	}
+	return now;
+}
@@ -0,0 +1,31 @@
+/*
+ * timestamp.h
+ *
+ *  Time base shared by the measurement modules (latency, cpu_load, boot_profile): Timer1 counts
+ *  (F_CPU/1024, 128us) since Timer1 started, TCNT1 plus ECU_TIMESTAMP_TOP + 1 for every
+ *  Timestamp_period() call, wrapping every 2^32 counts (6.4 days).
+ *  The Timer1 period (ECU_TIMESTAMP_TOP, ECU_TIMESTAMP_PERIOD_FLAG) comes from ecu_config.h of the ECU built.
+ */
+
+#ifndef TIMESTAMP_H_
+#define TIMESTAMP_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * To be called once per Timer1 period from its interrupt.
+ */
+void Timestamp_period(void);
+
+/*
+ * Description :
+ * Timer1 counts since Timer1 started, safe from anywhere (ISRs included).
+ */
+uint32 Timestamp_now(void);
+
+#endif /* TIMESTAMP_H_ */
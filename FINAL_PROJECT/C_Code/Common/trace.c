@@ -0,0 +1,161 @@
+/*
+ * trace.c
+ *
+ *  Event trace ring and its dump, see trace.h.
+ */
+
+#include "trace.h"
+#include "ecu_config.h"
+#include "UART.h"
+
+#include <avr/io.h>
+#include <util/atomic.h>
+
+#if (TRACE_ENABLE == TRUE)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static Trace_RecordType g_records[TRACE_BUFFER_SIZE];
+static volatile uint8 g_head = 0;         /* Next record written */
+static volatile uint8 g_count = 0;        /* Records held */
+static volatile uint8 g_lost = 0;         /* Records overwritten since the last dump (saturating) */
+static volatile uint8 g_periods = 0;      /* Timer1 periods since the last record (saturating) */
+static volatile uint8 g_paused = FALSE;   /* A dump is running */
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+/* Called with the interrupts disabled */
+static void Trace_put(uint8 id, uint8 arg, uint16 stamp)
+{
+	Trace_RecordType *record = &g_records[g_head];
+
+	record->id = id;
+	record->arg = arg;
+	record->stamp = stamp;
+	g_head = (g_head + 1) & (TRACE_BUFFER_SIZE - 1);
+
+	if(g_count < TRACE_BUFFER_SIZE)
+	{
+		g_count++;
+	}
+	else if(g_lost < 0xFF)
+	{
+		g_lost++;
+	}
+}
+
+static void Trace_send(uint8 data, uint8 *checksum)
+{
+	UART_sendByte(data);
+	*checksum += data;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Trace_init(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_head = 0;
+		g_count = 0;
+		g_lost = 0;
+		g_periods = 0;
+		g_paused = FALSE;
+	}
+}
+
+void Trace_record(uint8 id, uint8 arg)
+{
+	uint16 stamp;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if(!g_paused)
+		{
+			stamp = TCNT1;
+			if(g_periods != 0)
+			{
+				Trace_put(TRACE_WRAP, g_periods, stamp);
+				g_periods = 0;
+			}
+			Trace_put(id, arg, stamp);
+		}
+	}
+}
+
+void Trace_period(void)
+{
+	if(g_periods < 0xFF)
+	{
+		g_periods++;
+	}
+}
+
+void Trace_dump(void)
+{
+	uint8 count, lost, index, checksum = 0;
+	const Trace_RecordType *record;
+
+	/* Freeze the buffer, the UART bytes of the dump are not traced */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_paused = TRUE;
+		count = g_count;
+		lost = g_lost;
+	}
+
+	UART_sendByte(TRACE_FRAME_START);
+	Trace_send(ECU_ID, &checksum);
+	Trace_send(count, &checksum);
+	Trace_send(lost, &checksum);
+	Trace_send((uint8)ECU_TIMESTAMP_TOP, &checksum);
+	Trace_send((uint8)(ECU_TIMESTAMP_TOP >> 8), &checksum);
+
+	/* Oldest first */
+	index = (g_head - count) & (TRACE_BUFFER_SIZE - 1);
+	while(count != 0)
+	{
+		record = &g_records[index];
+		Trace_send(record->id, &checksum);
+		Trace_send(record->arg, &checksum);
+		Trace_send((uint8)record->stamp, &checksum);
+		Trace_send((uint8)(record->stamp >> 8), &checksum);
+		index = (index + 1) & (TRACE_BUFFER_SIZE - 1);
+		count--;
+	}
+	UART_sendByte(checksum);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_count = 0;
+		g_lost = 0;
+		g_paused = FALSE;
+	}
+}
+
+#endif /* TRACE_ENABLE */
+
+void Trace_skipFrame(void)
+{
+	uint16 left;
+
+#if (TRACE_ENABLE == TRUE)
+	g_paused = TRUE;                            /* The bytes skipped are not traced */
+#endif
+	(void)UART_recieveByte();                   /* ECU id */
+	left = (uint16)UART_recieveByte() * sizeof(Trace_RecordType);
+	left += TRACE_FRAME_HEADER_SIZE - 2 + 1;    /* Rest of the header and the checksum */
+	while(left != 0)
+	{
+		(void)UART_recieveByte();
+		left--;
+	}
+#if (TRACE_ENABLE == TRUE)
+	g_paused = FALSE;
+#endif
+}
@@ -0,0 +1,138 @@
+/*
+ * trace.h
+ *
+ *  Event trace: TRACE(id, arg) points in the application, the drivers and the ISRs store
+ *  4-byte records {id, arg, TCNT1} in an SRAM ring (the oldest are overwritten), dumped in
+ *  binary over the UART on request and turned into a timeline on a PC (host/trace_decode.c).
+ *
+ *  The timestamps are Timer1 counts (F_CPU/1024, 128us). Every Timer1 period Trace_period() is
+ *  called, the next record is then preceded by a TRACE_WRAP record holding the periods passed,
+ *  so the decoder can rebuild the time across any gap while the interrupts are enabled.
+ *  The ECU id and the Timer1 period (ECU_TIMESTAMP_TOP) come from ecu_config.h of the ECU built.
+ *
+ *  Dump frame (all bytes after the start byte are in the checksum):
+ *    TRACE_FRAME_START, ECU id, record count, records lost, timestamp top (2 bytes LE),
+ *    records {id, arg, stamp low, stamp high} oldest first, checksum (8-bit sum)
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Build with -DTRACE_ENABLE=0 to remove every trace point and the buffer */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE                   TRUE
+#endif
+
+#define TRACE_BUFFER_SIZE              64       /* Records (4 bytes each), must be a power of 2 */
+
+#define TRACE_REQUEST                  'T'      /* Link byte asking for a dump */
+#define TRACE_FRAME_START              0x7E
+#define TRACE_FRAME_HEADER_SIZE        5        /* ECU id, count, lost, top (2), after the start byte */
+
+/*
+ * Events: identifier, name for the decoder, event starting the span it ends (TRACE_NO_BEGIN if none).
+ * The list is the same on both ECUs, new events go at the end.
+ */
+#define TRACE_NO_BEGIN                 0xFF
+
+#define TRACE_EVENTS(EVENT)                                                                  \
+	EVENT(TRACE_WRAP,          "wrap",          TRACE_NO_BEGIN)      /* arg: Timer1 periods since the last record */ \
+	EVENT(TRACE_PHASE,         "phase",         TRACE_NO_BEGIN)      /* arg: phase entered */ \
+	EVENT(TRACE_UART_TX,       "uart-tx",       TRACE_NO_BEGIN)      /* arg: byte */          \
+	EVENT(TRACE_UART_RX_WAIT,  "uart-rx-wait",  TRACE_NO_BEGIN)                               \
+	EVENT(TRACE_UART_RX,       "uart-rx",       TRACE_UART_RX_WAIT)  /* arg: byte */          \
+	EVENT(TRACE_KEY_WAIT,      "key-wait",      TRACE_NO_BEGIN)                               \
+	EVENT(TRACE_KEY,           "key",           TRACE_KEY_WAIT)      /* arg: key returned */  \
+	EVENT(TRACE_KEY_PRESS,     "key-press",     TRACE_NO_BEGIN)      /* arg: key (scan ISR) */ \
+	EVENT(TRACE_KEY_WAKE,      "key-wake",      TRACE_NO_BEGIN)      /* INT0 ISR */           \
+	EVENT(TRACE_LCD_STRING,    "lcd-string",    TRACE_NO_BEGIN)      /* arg: first character */ \
+	EVENT(TRACE_LCD_DONE,      "lcd-done",      TRACE_LCD_STRING)    /* arg: characters sent */ \
+	EVENT(TRACE_LCD_CLEAR,     "lcd-clear",     TRACE_NO_BEGIN)                               \
+	EVENT(TRACE_EEPROM_READ,   "eeprom-read",   TRACE_NO_BEGIN)      /* arg: address A7..A0 */ \
+	EVENT(TRACE_EEPROM_WRITE,  "eeprom-write",  TRACE_NO_BEGIN)      /* arg: address A7..A0 */ \
+	EVENT(TRACE_EEPROM_DONE,   "eeprom-done",   TRACE_NO_BEGIN)      /* after a read or write that succeeded */ \
+	EVENT(TRACE_PASS_CHECK,    "pass-check",    TRACE_NO_BEGIN)      /* arg: command byte */  \
+	EVENT(TRACE_DOOR,          "door",          TRACE_NO_BEGIN)      /* arg: door state entered */ \
+	EVENT(TRACE_DOOR_REOPEN,   "door-reopen",   TRACE_NO_BEGIN)      /* arg: 1 stall, 0 motion */ \
+	EVENT(TRACE_ALARM,         "alarm",         TRACE_NO_BEGIN)                               \
+	EVENT(TRACE_MOTOR_START,   "motor-start",   TRACE_NO_BEGIN)      /* arg: direction */     \
+	EVENT(TRACE_MOTOR_STOP,    "motor-stop",    TRACE_NO_BEGIN)      /* ramp down */          \
+	EVENT(TRACE_MOTOR_HALT,    "motor-halt",    TRACE_NO_BEGIN)      /* brake now */          \
+	EVENT(TRACE_MOTOR_IDLE,    "motor-idle",    TRACE_NO_BEGIN)      /* ramp finished (PWM ISR) */ \
+	EVENT(TRACE_PIR_EDGE,      "pir-edge",      TRACE_NO_BEGIN)      /* arg: pin level (PIR_poll) */ \
+	EVENT(TRACE_PIR_STATE,     "pir-state",     TRACE_NO_BEGIN)      /* arg: filtered state */ \
+	EVENT(TRACE_STALL,         "stall",         TRACE_NO_BEGIN)      /* arg: average / 4 (ADC ISR) */ \
+	EVENT(TRACE_STACK,         "stack",         TRACE_NO_BEGIN)      /* arg: stack bytes never used / 8 */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+#define TRACE_ENUM_ENTRY(ID, NAME, BEGIN)   ID,
+typedef enum
+{
+	TRACE_EVENTS(TRACE_ENUM_ENTRY)
+	TRACE_NUM_OF_EVENTS
+} Trace_IdType;
+#undef TRACE_ENUM_ENTRY
+
+typedef struct
+{
+	uint8 id;
+	uint8 arg;
+	uint16 stamp;      /* TCNT1 */
+} Trace_RecordType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+#if (TRACE_ENABLE == TRUE)
+
+#define TRACE(id, arg)                 Trace_record((id), (uint8)(arg))
+
+/*
+ * Description :
+ * Clear the buffer.
+ */
+void Trace_init(void);
+
+/*
+ * Description :
+ * Store one record, safe from the main loop and from the ISRs. Dropped while a dump runs.
+ */
+void Trace_record(uint8 id, uint8 arg);
+
+/*
+ * Description :
+ * To be called once per Timer1 period from its interrupt.
+ */
+void Trace_period(void);
+
+/*
+ * Description :
+ * Send the records over the UART (see the frame above) and clear the buffer.
+ */
+void Trace_dump(void);
+
+/*
+ * Description :
+ * Read and drop a frame of the other ECU after its start byte was received.
+ */
+void Trace_skipFrame(void);
+
+#else
+
+#define TRACE(id, arg)                 ((void)0)
+#define Trace_init()                   ((void)0)
+#define Trace_period()                 ((void)0)
+#define Trace_dump()                   ((void)0)
+void Trace_skipFrame(void);
+
+#endif
+
+#endif /* TRACE_H_ */
@@ -5,25 +5,35 @@
  *      Author: amr mohamed
  */
 
+#include "adc.h"
+#include "boot_profile.h"
 #include "buzzer.h"
 #include "common_macros.h"
+#include "cpu_load.h"
+#include "door_position.h"
 #include "external_eeprom.h"
 #include "gpio.h"
 #include "I2C.h"
+#include "latency.h"
 #include "motor.h"
+#include "motor_ramp.h"
 #include "PIR.h"
 #include "PWM.h"
+#include "stack_monitor.h"
 #include "std_types.h"
 #include "Timer.h"
+#include "timestamp.h"
+#include "trace.h"
 #include "UART.h"
 #include <util/delay.h>
 #include <avr/io.h> /* To use the SREG register */
+#include <avr/sleep.h>
 
 /*
  * Variable to track the elapsed time in seconds.
  * This is used to manage timing for various operations, such as door opening and closing.
  */
-uint8 seconds = 0;
+volatile uint8 seconds = 0;  /* Counted by the timer interrupt, read and cleared by the main loop */
 
 /*
  * Variable to count the number of consecutive password mismatches.
@@ -36,6 +46,20 @@ uint8 g_error = 0;
  * This is used to control state transitions within the functions in here.
  */
 uint8 phaseSwitches = 1;
+
+/*
+ * The password is stored in the EEPROM from PASS_EEPROM_ADDRESS, PASS_LENGTH digits.
+ */
+#define PASS_EEPROM_ADDRESS 0x0001
+#define PASS_LENGTH 5
+
+/*
+ * Copy of the stored password, read once at boot and updated on every store, so a verification
+ * (the first one after a power cut included) never waits on the I2C bus.
+ * Not valid when the EEPROM could not be read at boot, the verification then reads the EEPROM.
+ */
+uint8 g_passCache[PASS_LENGTH];
+uint8 g_passCacheValid = 0;
 /************************************************************************************************************/
 /************************************************************************************************************/
 /*
@@ -49,17 +73,64 @@ typedef enum {
     Done               /* State indicating the operation is complete */
 } doorState;
 
+/*
+ * Speed profiles of the door motor: soft start to full speed and cruise,
+ * then slow down to the approach speed near the end stop.
+ */
+static const MotorRamp_ProfileType g_doorProfile = {100, 1000, 0, 1000};
+static const MotorRamp_ProfileType g_doorApproachProfile = {30, 0, 0, 500};
+
+/*
+ * Longest travel time (in timer ticks) before the door is stopped anyway,
+ * in case an end stop is never seen (encoder or switch failure).
+ */
+#define DOOR_TRAVEL_TIMEOUT 15
+
+/*
+ * Motor current sensing on the shunt (ADC1/PA1): an average at or above DOOR_STALL_THRESHOLD
+ * means the door is jammed. The inrush current of a starting motor is ignored for
+ * DOOR_INRUSH_BLANKING averages (about 3.3 ms each, so about 300 ms).
+ */
+#define DOOR_CURRENT_CHANNEL 1
+#define DOOR_STALL_THRESHOLD 150
+#define DOOR_INRUSH_BLANKING 90
+
+/*
+ * Flag set from the ADC interrupt when the motor stalled.
+ * The motor is already stopped at that point, the door state machine decides what happens next.
+ */
+volatile uint8 g_motorStall = 0;
+
+/*
+ * Motion seen while closing: the door opens again, but only back to where the close started.
+ * After DOOR_REOPEN_LIMIT re-opens in one cycle motion is ignored and the door closes
+ * (a stall still always re-opens it).
+ */
+#define DOOR_REOPEN_LIMIT 3
+
+/* Set while the door is closing, so the PIR motion callback knows whether to react */
+volatile uint8 g_doorClosing = 0;
+
+/* Set from the PIR motion callback when motion stopped a close, the motor is already stopped */
+volatile uint8 g_motionReopen = 0;
+
+/* Number of re-opens caused by motion in the current cycle */
+volatile uint8 g_reopenCount = 0;
+
+/* Filtered PIR state on the previous tick, to see it become clear */
+uint8 g_pirOccupied = 0;
+
 /*
  * Initialize the timer state for the door motor to OPENING_DOOR.
  * This sets the initial state of the system when it starts.
  */
-doorState timerState = OPENING_DOOR;
+volatile doorState timerState = OPENING_DOOR;
 
 /*
  * Variable to track the alarm state.
  * This is set to 0 initially, and may be updated based on system conditions.
  */
-uint8 alarmState = 0;
+volatile uint8 alarmState = 0;
 
 /*
  * Enumeration to define the different UART states for door operations.
@@ -80,6 +151,11 @@ typedef enum {
  */
 void passStoreCheck(void);
 
+/*
+ * Function to read the stored password into its RAM copy (g_passCache), at boot.
+ */
+void passCacheLoad(void);
+
 /*
  * Function to manage the door motor's operation.
  * This function handles the states of opening, waiting for people, and closing the door,
@@ -87,6 +163,27 @@ void passStoreCheck(void);
  */
 void doorHandler(void);
 
+/*
+ * Function to drive the door to the target position in the given direction, called on every pass while the door moves.
+ * It returns TRUE once the motor has stopped.
+ */
+uint8 doorTravel(DcMotor_State direction, sint16 target);
+
+/*
+ * Function called from the PIR edge check (PIR_poll) on motion.
+ */
+void motionCallBack(void);
+
+/*
+ * Function called from the ADC interrupt when the motor current reaches the stall threshold.
+ */
+void motorStallCallBack(void);
+
+/*
+ * Function called from the UART driver: the trace records of the link and the idle time of the waits for a byte.
+ */
+void uartCallBack(UART_EventType event, uint8 data);
+
 /*
  * Function to handle the alarm state.
  * This function activates a buzzer for 60 seconds if the password is entered incorrectly three times,
@@ -96,6 +193,16 @@ void alarmStage(void);
 /************************************************************************************************************/
 /************************************************************************************************************/
 void timerCallBackRuntime(void) {
+    /* One more Timer1 period for the trace and the measurement time base (timestamp.h), in every phase */
+    Trace_period();
+    Timestamp_period();
+    StackMonitor_check();  /* A part of the stack paint on every period */
+
+    /* The door timing and the PIR filter are paused while the passwords are handled */
+    if (phaseSwitches == 1) {
+        return;
+    }
+
     /* Switch statement to handle different timer states */
     switch (timerState) {
         /* State for opening the door */
@@ -120,6 +227,15 @@ void timerCallBackRuntime(void) {
             break;
     }
 
+    /* Filter the PIR sensor on this tick */
+    PIR_tick();
+
+    /* Nobody in front of the open door anymore, the close starts from here (see latency.h) */
+    if (timerState == WAITING_FOR_PEOPLE && g_pirOccupied && !PIR_isOccupied()) {
+        Latency_start(LATENCY_CLEAR_CLOSE);
+    }
+    g_pirOccupied = PIR_isOccupied();
+
     /* Check if the alarm state is activated */
     if (alarmState == 0xFF) {
         seconds++;  /* Increment the seconds counter if the alarm is active */
@@ -127,37 +243,85 @@ void timerCallBackRuntime(void) {
 }
 /************************************************************************************************************/
 /************************************************************************************************************/
+void uartCallBack(UART_EventType event, uint8 data) {
+    switch (event) {
+        case UART_EVENT_TX:
+            TRACE(TRACE_UART_TX, data);
+            break;
+        case UART_EVENT_RX_WAIT:
+            TRACE(TRACE_UART_RX_WAIT, 0);
+            CpuLoad_idleBegin();  /* Waiting for the HMI, the CPU only polls the UART */
+            break;
+        case UART_EVENT_RX:
+            CpuLoad_idleEnd();
+            TRACE(TRACE_UART_RX, data);
+            break;
+    }
+    (void)data;  /* Not used when the trace is built out */
+}
+/************************************************************************************************************/
+/************************************************************************************************************/
 int main(void) {
     /* Configuration structures for various peripherals */
     UART_Config UARTRuntime = {9600, DISABLED, EIGHT_BITS, ONE_BIT};  /* UART configuration */
     Timer_ConfigType TimerRuntime = {0, 2930, Timer_1, Fcpu_1024, COMPARE_MODE};  /* Timer configuration */
     I2C_Config I2CRuntime = {CPU_8MHZ, I2C_400KHZ, 0xAA};  /* I2C configuration with address 0xAA */
+    ADC_ConfigType ADCRuntime = {ADC_AVCC, ADC_FCPU_128, DOOR_CURRENT_CHANNEL};  /* Motor current sensing */
 
     /* Initialize peripherals */
-    Timer_init(&TimerRuntime);  /* Initialize the timer with the specified configuration */
+    Trace_init();                /* Empty trace buffer, stamped from the Timer1 tick below */
+    Latency_init();              /* Empty latency histograms, timed by the same tick */
+    CpuLoad_init();              /* Idle time accounting, timed by the same tick */
+    StackMonitor_init();         /* Stack high-water mark, the stack was painted before main() */
+    Timer_init(&TimerRuntime);  /* Initialize the timer with the specified configuration, the boot time starts */
     UART_Init(&UARTRuntime);    /* Initialize UART communication */
+    UART_setCallBack(uartCallBack);  /* Trace and idle time of the link */
+    BootProfile_mark(BOOT_UART);
+    I2C_init(&I2CRuntime);       /* Initialize I2C communication */
+    passCacheLoad();             /* The stored password in RAM before the first verification */
+    BootProfile_mark(BOOT_EEPROM);
     DcMotor_Init();              /* Initialize the DC motor control */
+    DoorPosition_init();         /* Initialize the door encoder and end stop switches */
     PIR_init();                  /* Initialize the PIR sensor */
+    PIR_setMotionCallBack(motionCallBack);  /* Stop a close as soon as someone walks in */
     Buzzer_init();               /* Initialize the buzzer */
-    PWM_Timer0_Start(100);      /* Start PWM on Timer0 with a duty cycle of 100 */
-    I2C_init(&I2CRuntime);       /* Initialize I2C communication */
+    PWM_Timer0_Start(0);        /* Start PWM on Timer0, the motor speed is set by DcMotor_Rotate */
+    MotorRamp_init();            /* Soft start / soft stop of the motor, runs from the PWM interrupt */
+    ADC_init(&ADCRuntime);       /* Motor current sensing, sampled by motor_ramp while the motor is driven */
+    ADC_setThresholdCallBack(motorStallCallBack);  /* Stop the motor as soon as it stalls */
+    BootProfile_mark(BOOT_DRIVERS);
     Timer_setCallBack(timerCallBackRuntime, Timer_1);  /* Set the callback function for Timer_1 */
+    set_sleep_mode(SLEEP_MODE_IDLE);  /* The timers, the ADC and the UART keep running while waiting */
+    BootProfile_mark(BOOT_READY);  /* Waiting for the first byte of the HMI from here */
 
     /* Main loop */
     while (1) {
+        CpuLoad_setPhase(phaseSwitches);  /* The CPU time from here on belongs to this phase */
+
         /* Check the current phase and execute the corresponding function */
         if (phaseSwitches == 1) {
-            SREG &= ~(1<<7);  /* Disable Global Interrupt (I-Bit) for safe operation */
+            SREG |= (1<<7);  /* Enable Global Interrupt (I-Bit), the timer callback pauses the door timing */
             passStoreCheck();  /* Call the function to check and store passwords */
         }
         else if (phaseSwitches == 2) {
             SREG |= (1<<7);  /* Enable Global Interrupt (I-Bit) for door handling */
+            PIR_poll();       /* A rising edge of the PIR stops a close right away */
             doorHandler();    /* Call the function to manage the door operation */
         }
         else if (phaseSwitches == 3) {
             SREG |= (1<<7);  /* Enable Global Interrupt (I-Bit) for alarm handling */
             alarmStage();     /* Call the function to manage the alarm state */
         }
+
+        /*
+         * The door and the alarm only move on from an interrupt (encoder, ADC, PWM ramp, timer tick),
+         * sleep until the next one instead of polling, that time counts as idle
+         */
+        if (phaseSwitches != 1) {
+            CpuLoad_idleBegin();
+            sleep_mode();
+            CpuLoad_idleEnd();
+        }
     }
 }
 
@@ -170,6 +334,14 @@ int main(void) {
  * 4. If a mismatch occurs during verification, a global variable (g_error) tracks the number of mismatches.
  * 5. An indication of failure ('Z') is sent to the HMI to prompt the user to try again.
  * 6. If g_error reaches 3, the function transitions to an alarm state.
+ * 7. A byte 'T' (TRACE_REQUEST) dumps the trace buffer, a trace frame sent by the HMI is read and dropped.
+ * 8. A byte 'L' (LATENCY_REQUEST) dumps the latency histograms and 'R' (LATENCY_RESET) clears them,
+ *    a latency frame sent by the HMI is read and dropped.
+ * 9. A byte 'U' (CPULOAD_REQUEST) dumps the CPU load, a CPU load frame sent by the HMI is read and dropped.
+ * 10. A byte 'M' (STACKMON_REQUEST) dumps the RAM use, a RAM frame sent by the HMI is read and dropped.
+ * 11. A byte 'B' (BOOT_REQUEST) dumps the boot profile, a boot frame sent by the HMI is read and dropped.
+ *
+ * The stored password is compared from its RAM copy (g_passCache), kept equal to the EEPROM on every store.
  */
 void passStoreCheck(void) {
     /* Static variables to hold the state of the password storage and comparison */
@@ -178,22 +350,25 @@ void passStoreCheck(void) {
 
     /* Receive a byte from UART */
     RByte = UART_recieveByte();
+    TRACE(TRACE_PASS_CHECK, RByte);
 
     /* Check if the received byte is 'F' to start password comparison */
     if (RByte == 'F') {
         storeLimit = 0;  /* Reset store limit for comparison */
 
         /* Loop to compare 5 stored password bytes */
-        while (storeLimit < 5) {
+        while (storeLimit < PASS_LENGTH) {
             storedByte = UART_recieveByte();  /* Receive the password byte */
 
             /* Check if the received byte is not a space */
             if (storedByte != ' ') {
 
-                /* Read the stored byte from EEPROM for comparison */
-                if (EEPROM_readByte(0x0001 + storeLimit, &compareByte) == ERROR) {
+                /* The stored byte from its RAM copy, or from EEPROM if it could not be loaded */
+                if (g_passCacheValid) {
+                    compareByte = g_passCache[storeLimit];
+                } else if (EEPROM_readByte(PASS_EEPROM_ADDRESS + storeLimit, &compareByte) == ERROR) {
                     /* Set a GPIO pin high if there's an error reading EEPROM */
-                    GPIO_writePin(PORTA_ID, PIN0_ID, LOGIC_HIGH);
+                    GPIO_WRITE_PIN(PORTA_ID, PIN0_ID, LOGIC_HIGH);
                 }
 
                 /* Compare the received byte with the stored byte */
@@ -204,6 +379,7 @@ void passStoreCheck(void) {
                     g_error++;
                     /* Check if error count has reached 3 */
                     if (g_error == 3) {
+                        TRACE(TRACE_ALARM, 1);
                         alarmState = 0xFF;  /* Trigger alarm state */
                         phaseSwitches = 3;   /* Change phase */
                         g_error = 0;         /* Reset error count */
@@ -220,6 +396,7 @@ void passStoreCheck(void) {
 
         /* If no mismatch was found */
         if (flag == 0) {
+            Latency_start(LATENCY_AUTH_MOTOR);  /* Until the motor opens the door */
             UART_sendByte('X');  /* Send indication of successful match */
             phaseSwitches = 2;    /* Change phase */
         }
@@ -229,47 +406,108 @@ void passStoreCheck(void) {
         storeLimit = 0;  /* Reset store limit for storing new password */
 
         /* Loop to store 5 password bytes */
-        while (storeLimit < 5) {
+        while (storeLimit < PASS_LENGTH) {
             storedByte = UART_recieveByte();  /* Receive the password byte */
 
             /* Check if the received byte is not a space */
             if (storedByte != ' ') {
-                /* Write the received byte to EEPROM */
-                EEPROM_writeByte(0x0001 + storeLimit, storedByte);
+                /* Write the received byte to EEPROM and to its RAM copy */
+                EEPROM_writeByte(PASS_EEPROM_ADDRESS + storeLimit, storedByte);
+                g_passCache[storeLimit] = storedByte;
                 _delay_ms(10);  /* Delay to allow EEPROM write completion */
                 storeLimit++;  /* Increment store limit for next byte */
             }
         }
         storeLimit = 0;  /* Reset store limit after storing */
+        g_passCacheValid = 1;  /* The RAM copy holds the whole new password */
+
+    /* A trace dump asked on the link (see trace.h) */
+    } else if (RByte == TRACE_REQUEST) {
+        Trace_dump();
+
+    /* A trace dump of the HMI crossing the link, its bytes are not commands */
+    } else if (RByte == TRACE_FRAME_START) {
+        Trace_skipFrame();
+
+    /* Latency histograms asked or cleared on the link (see latency.h) */
+    } else if (RByte == LATENCY_REQUEST) {
+        Latency_dump();
+    } else if (RByte == LATENCY_RESET) {
+        Latency_reset();
+
+    /* A latency dump of the HMI crossing the link */
+    } else if (RByte == LATENCY_FRAME_START) {
+        Latency_skipFrame();
+
+    /* CPU load asked on the link (see cpu_load.h), or the one of the HMI crossing it */
+    } else if (RByte == CPULOAD_REQUEST) {
+        CpuLoad_dump();
+    } else if (RByte == CPULOAD_FRAME_START) {
+        CpuLoad_skipFrame();
+
+    /* RAM use and stack high-water mark asked on the link (see stack_monitor.h), or the ones of the HMI */
+    } else if (RByte == STACKMON_REQUEST) {
+        StackMonitor_dump();
+    } else if (RByte == STACKMON_FRAME_START) {
+        StackMonitor_skipFrame();
+
+    /* Boot profile asked on the link (see boot_profile.h), or the one of the HMI crossing it */
+    } else if (RByte == BOOT_REQUEST) {
+        BootProfile_dump();
+    } else if (RByte == BOOT_FRAME_START) {
+        BootProfile_skipFrame();
     }
 }
 
+/*
+ * Read the PASS_LENGTH stored digits once, the verifications then compare against this copy.
+ * On a read error the copy stays invalid and every verification reads the EEPROM as before.
+ */
+void passCacheLoad(void) {
+    uint8 index;
+
+    for (index = 0; index < PASS_LENGTH; index++) {
+        if (EEPROM_readByte(PASS_EEPROM_ADDRESS + index, &g_passCache[index]) == ERROR) {
+            g_passCacheValid = 0;
+            return;
+        }
+    }
+    g_passCacheValid = 1;
+}
+
 /*
  * This function manages the operation of a door motor based on the following states:
  *
  * 1. OPENING_DOOR:
- *    - The motor runs forward (clockwise) for 15 seconds to open the door.
+ *    - The motor ramps up forward (clockwise) until the door reaches its open end stop.
  *    - If the state has not been previously sent, it sends the OPEN_BYTE to the UART.
- *    - After 15 seconds, the motor stops, and the state transitions to WAITING_FOR_PEOPLE.
+ *    - Once the motor has stopped, the state transitions to WAITING_FOR_PEOPLE.
  *
  * 2. WAITING_FOR_PEOPLE:
  *    - The motor remains stopped while waiting for people to enter.
  *    - If the state has not been previously sent, it sends the WAIT_BYTE to the UART.
- *    - The function checks the PIR sensor state; if the sensor detects motion (LOGIC_LOW), it transitions to CLOSING_DOOR.
+ *    - The function checks the filtered PIR state; once nobody is there anymore, it transitions to CLOSING_DOOR.
  *
  * 3. CLOSING_DOOR:
- *    - The motor runs backward (anti-clockwise) for 15 seconds to close the door.
+ *    - The motor ramps up backward (anti-clockwise) until the door reaches its closed end stop.
  *    - If the state has not been previously sent, it sends the CLOSE_BYTE to the UART.
- *    - After 15 seconds, the motor stops, and the state resets to OPENING_DOOR, completing the cycle.
+ *    - Once the motor has stopped, the state resets to OPENING_DOOR, completing the cycle.
  *    - It also sends a completion byte (Done) to indicate the operation is finished.
  *
+ * If the motor stalls while closing (something is in the way), or the PIR sees motion while closing,
+ * the door opens again back to where the close started (motion only up to DOOR_REOPEN_LIMIT times).
+ * If it stalls while opening, the door stays where it is and the system waits for people.
+ *
  * The function uses a static state variable to track the current motor state and a flag to ensure that state change notifications are sent only once per state.
+ * The motor commands are issued once per state, the ramp itself runs in the background (motor_ramp).
  */
 void doorHandler(void) {
     /* Static variable to track the current state of the door motor */
     static doorState motorState = OPENING_DOOR;
     static uint8_t byteSent = 0;  /* Flag to indicate if a byte was sent for the current state */
-
+    static sint16 openTarget = DOOR_POSITION_OPEN;  /* Where the door opens to */
+    static sint16 closeStart = DOOR_POSITION_OPEN;  /* Where the last close started */
+    uint8 stopped;  /* Flag to indicate the motor has stopped */
 
     /* Switch statement to handle different motor states */
     switch (motorState) {
@@ -279,14 +517,24 @@ void doorHandler(void) {
             /* Check if the byte has not been sent yet */
             if (!byteSent) {
                 UART_sendByte(OPEN_BYTE);  /* Send a byte to indicate the door is opening */
+                TRACE(TRACE_DOOR, OPENING_DOOR);
+                DoorPosition_startTravel();  /* The encoder count is trusted once it moves */
+                seconds = 0;  /* Restart the travel time */
+                MotorRamp_start(CW, &g_doorProfile);  /* Ramp the motor up clockwise to open the door */
+                Latency_stop(LATENCY_AUTH_MOTOR);  /* Only after a password, not on a re-open */
+                if (!Buzzer_isPlaying()) {
+                    Buzzer_play(BUZZER_CHIRP);  /* Short beep as the door starts moving */
+                }
+                g_motorStall = 0;
+                ADC_armThreshold(DOOR_STALL_THRESHOLD, DOOR_INRUSH_BLANKING);  /* Watch for a stall */
                 byteSent = 1;  /* Set flag to prevent re-sending */
             }
 
-            DcMotor_Rotate(CW, 100);  /* Rotate the motor clockwise to open the door */
+            /* A stall while opening only stops the door (motor already stopped) */
+            g_motorStall = 0;
 
-            /* Check if 15 seconds have passed */
-            if (seconds > 15) {
-                DcMotor_Rotate(STOP, 0);  /* Stop the motor */
+            /* Wait for the door to reach the open position */
+            if (doorTravel(CW, openTarget)) {
                 motorState = WAITING_FOR_PEOPLE;  /* Transition to waiting state */
                 byteSent = 0;  /* Reset byte sent flag */
                 timerState = WAITING_FOR_PEOPLE;  /* Update timer state */
@@ -295,17 +543,16 @@ void doorHandler(void) {
 
         /* State for waiting for people to enter */
         case WAITING_FOR_PEOPLE:
-            DcMotor_Rotate(STOP, 0);  /* Keep the motor stopped */
-
             /* Check if the byte has not been sent yet */
             if (!byteSent) {
                 UART_sendByte(WAIT_BYTE);  /* Send a byte indicating the system is waiting */
+                TRACE(TRACE_DOOR, WAITING_FOR_PEOPLE);
                 byteSent = 1;  /* Set flag to prevent re-sending */
             }
 
-            /* Check the PIR sensor state */
-            if (PIR_getState() == LOGIC_LOW) {
-                motorState = CLOSING_DOOR;  /* Transition to closing state if motion is detected */
+            /* Check the filtered PIR state, a single noisy sample can't close the door */
+            if (!PIR_isOccupied()) {
+                motorState = CLOSING_DOOR;  /* Transition to closing state once nobody is there */
                 byteSent = 0;  /* Reset byte sent flag */
                 timerState = CLOSING_DOOR;  /* Update timer state */
             }
@@ -316,21 +563,129 @@ void doorHandler(void) {
             /* Check if the byte has not been sent yet */
             if (!byteSent) {
                 UART_sendByte(CLOSE_BYTE);  /* Send a byte to indicate the door is closing */
+                TRACE(TRACE_DOOR, CLOSING_DOOR);
+                closeStart = DoorPosition_get();  /* Remember where the close started */
+                g_motorStall = 0;
+                g_motionReopen = 0;
+                DoorPosition_startTravel();  /* The encoder count is trusted once it moves */
+                seconds = 0;  /* Restart the travel time, waiting may not have seen a tick */
+                MotorRamp_start(A_CW, &g_doorProfile);  /* Ramp the motor up counter-clockwise to close the door */
+                Latency_stop(LATENCY_CLEAR_CLOSE);  /* Not counted when nobody was there as the door opened */
+                ADC_armThreshold(DOOR_STALL_THRESHOLD, DOOR_INRUSH_BLANKING);  /* Watch for a stall */
+                g_doorClosing = 1;  /* Let the PIR motion callback stop the close */
                 byteSent = 1;  /* Set flag to prevent re-sending */
             }
 
-            DcMotor_Rotate(A_CW, 100);  /* Rotate the motor counter-clockwise to close the door */
+            /* Motion the edge check did not see as an edge (pin already high), reported by the filter */
+            if (!g_motionReopen && g_reopenCount < DOOR_REOPEN_LIMIT && PIR_getEvent() == PIR_OCCUPIED) {
+                MotorRamp_halt();  /* Stop the motor right now */
+                g_motionReopen = 1;
+            }
+
+            /*
+             * Follow the door first, then look at the flags: the interrupts stop the motor
+             * before they set their flag, so a stop caused by them is never taken for the end of the close
+             */
+            stopped = doorTravel(A_CW, DOOR_POSITION_CLOSED);
+
+            /* Something is in the way, open the door again but only back to where the close started */
+            if (g_motorStall || g_motionReopen) {
+                TRACE(TRACE_DOOR_REOPEN, g_motorStall);
+                if (g_motorStall) {
+                    Buzzer_play(BUZZER_ERROR);  /* Warn that the door hit something */
+                } else {
+                    g_reopenCount++;  /* Count the re-opens caused by motion */
+                }
+                g_motorStall = 0;
+                g_motionReopen = 0;
+                g_doorClosing = 0;
+                openTarget = closeStart;  /* Reverse only the distance already travelled */
+                motorState = OPENING_DOOR;  /* Reverse, open the door again */
+                byteSent = 0;  /* Reset byte sent flag */
+                timerState = OPENING_DOOR;  /* Update timer state */
+                break;
+            }
 
-            /* Check if 15 seconds have passed */
-            if (seconds > 15) {
-                DcMotor_Rotate(STOP, 0);  /* Stop the motor */
+            /* Wait for the door to reach the closed end stop */
+            if (stopped) {
+                g_doorClosing = 0;
+                g_reopenCount = 0;  /* New cycle, new re-open budget */
+                openTarget = DOOR_POSITION_OPEN;  /* Next cycle opens fully */
                 motorState = OPENING_DOOR;  /* Reset state to opening */
                 phaseSwitches = 1;  /* Update phase switches */
                 byteSent = 0;  /* Reset byte sent flag */
                 timerState = Done;  /* Update timer state */
+                TRACE(TRACE_DOOR, Done);
                 UART_sendByte(Done);  /* Send a completion byte indicating the operation is finished */
             }
             break;
+
+        /* Done is only a timer state and a byte to the HMI, the door never stays in it */
+        case Done:
+            motorState = OPENING_DOOR;
+            break;
+    }
+}
+
+/*
+ * This function follows the door position while the motor moves it:
+ *
+ * 1. Near the target (DOOR_APPROACH_DISTANCE counts) the motor slows down to the approach speed.
+ * 2. At the target or at the end stop (switch pressed or encoder count reached) the motor stops right away.
+ * 3. If no end stop is seen within DOOR_TRAVEL_TIMEOUT, the motor ramps down anyway.
+ *
+ * The target and the slow-down only use the encoder count once it gave a pulse on this move:
+ * without an encoder (or a broken one) the count never changes, so the door runs to its end stop
+ * switch or to the timeout instead of being taken as arrived.
+ *
+ * The position is kept between moves, so a door stopped half way only travels the remaining distance.
+ */
+uint8 doorTravel(DcMotor_State direction, sint16 target) {
+    static uint8 approaching = 0;  /* Flag to indicate the approach speed was already requested */
+    sint16 position = DoorPosition_get();
+    uint8 tracking = DoorPosition_isTracking();
+    uint8 reached = tracking && ((direction == CW) ? (position >= target) : (position <= target));
+
+    /* The move is over once the motor has stopped */
+    if (MotorRamp_getState() == MOTOR_RAMP_IDLE) {
+        ADC_disarmThreshold();  /* No stall detection while stopped */
+        approaching = 0;
+        return TRUE;
+    }
+
+    if (reached || DoorPosition_atEndStop(direction)) {
+        MotorRamp_halt();  /* Target or end stop reached, brake right here */
+    }
+    else if (seconds > DOOR_TRAVEL_TIMEOUT) {
+        MotorRamp_stop();  /* No end stop seen in time, ramp the motor down */
+    }
+    else if (tracking && !approaching && DoorPosition_distanceTo(target) <= DOOR_APPROACH_DISTANCE) {
+        MotorRamp_start(direction, &g_doorApproachProfile);  /* Slow down before the target */
+        approaching = 1;
+    }
+
+    return FALSE;
+}
+
+/*
+ * Called from the ADC interrupt, so the motor stops within a few ms of a stall
+ * instead of running against the obstacle until the travel timeout.
+ */
+void motorStallCallBack(void) {
+    MotorRamp_halt();  /* Stop the motor right now */
+    g_motorStall = 1;  /* Let the door state machine react */
+}
+
+/*
+ * Called from PIR_poll() on a rising edge, so a close stops within a few ms of someone
+ * walking in instead of waiting for the filtered state: while the door moves, the PWM
+ * interrupt wakes the main loop every period (~2ms).
+ */
+void motionCallBack(void) {
+    if (g_doorClosing && g_reopenCount < DOOR_REOPEN_LIMIT) {
+        MotorRamp_halt();  /* Stop the motor right now */
+        g_doorClosing = 0;
+        g_motionReopen = 1;  /* Let the door state machine re-open the door */
     }
 }
 
@@ -338,7 +693,7 @@ void doorHandler(void) {
  * this function works as follows:
  *
  * 1. if the password is wrong for 3 consecutive times, we come here
- * 2. i turn the buzzer on for 60 seconds, while i already in the first function sent to the HMI to display error message.
+ * 2. i play the alarm siren for 60 seconds (in the background from Timer2), while i already in the first function sent to the HMI to display error message.
  * 3. after the 60 seconds, everything returns to the inital state and the system returns to the normal operations
  * */
 void alarmStage(void) {
@@ -348,7 +703,11 @@ void alarmStage(void) {
     /* Check if the elapsed time is less than 60 seconds */
     if (seconds < 60)
     {
-        Buzzer_on();  /* Activate the buzzer to indicate an alarm state */
+        /* Start the alarm siren, it repeats by itself until stopped */
+        if (!Buzzer_isPlaying())
+        {
+            Buzzer_play(BUZZER_ALARM);
+        }
     }
     /* If 60 seconds have passed */
     else {
@@ -359,7 +718,8 @@ void alarmStage(void) {
             byteSent = 1;  /* Set flag to prevent re-sending */
         }
 
-        Buzzer_off();  /* Deactivate the buzzer after the alarm duration */
+        Buzzer_stop();  /* Deactivate the buzzer after the alarm duration */
+        TRACE(TRACE_ALARM, 0);
         byteSent = 0;  /* Reset the byte sent flag for future operations */
         alarmState = 0;  /* Reset the alarm state to indicate normal operation */
         phaseSwitches = 1;  /* Update phase switches to return to normal operations */
@@ -8,13 +8,106 @@
 #include "std_types.h"
 #include "PIR.h"
 #include "gpio.h"
+#include "common_macros.h"
+#include "trace.h"
+#include <avr/io.h>
+#include <util/atomic.h>
+
+static void (*volatile g_CallBackMotion)(void) = NULL_PTR;
+
+static volatile uint8 g_occupied = FALSE;				/*filtered state*/
+static volatile PIR_EventType g_event = PIR_NO_EVENT;	/*last transition not read yet*/
+
+static uint8 g_lastLevel = LOGIC_LOW;		/*pin level at the last PIR_poll*/
+
+static uint8 g_votesLeft = 0;				/*ticks left in the running vote, 0 = no vote*/
+static uint8 g_highVotes = 0;				/*ticks of the running vote with the pin high*/
+static uint8 g_holdOff = 0;					/*ticks before a new state may be reported*/
 
 void PIR_init(void)
 {
-	GPIO_setupPinDirection(PIR_PORT, PIR_PIN, PIN_INPUT);
+	GPIO_SETUP_PIN_DIRECTION(PIR_PORT, PIR_PIN, PIN_INPUT);
+
+	g_lastLevel = GPIO_READ_PIN(PIR_PORT, PIR_PIN);
+	g_occupied = (g_lastLevel == LOGIC_HIGH);
+	g_event = PIR_NO_EVENT;
+	g_votesLeft = 0;
+	g_holdOff = 0;
+}
+
+void PIR_poll(void)
+{
+	uint8 level = GPIO_READ_PIN(PIR_PORT, PIR_PIN);
+
+	if (level == g_lastLevel) {
+		return;
+	}
+	g_lastLevel = level;
+	TRACE(TRACE_PIR_EDGE, level);
+
+	if ((g_CallBackMotion != NULL_PTR) && (level == LOGIC_HIGH)) {
+		(*g_CallBackMotion)();
+	}
 }
 
 uint8 PIR_getState(void)
 {
-	return GPIO_readPin(PIR_PORT, PIR_PIN);
+	return GPIO_READ_PIN(PIR_PORT, PIR_PIN);
+}
+
+void PIR_tick(void)
+{
+	uint8 occupied;
+
+	if (g_holdOff != 0) {
+		g_holdOff--;
+	}
+
+	/*no vote running, start one only if the pin disagrees with the reported state*/
+	if (g_votesLeft == 0) {
+		if ((GPIO_READ_PIN(PIR_PORT, PIR_PIN) == LOGIC_HIGH) == g_occupied) {
+			return;
+		}
+		g_votesLeft = PIR_VOTE_SAMPLES;
+		g_highVotes = 0;
+	}
+
+	if (GPIO_READ_PIN(PIR_PORT, PIR_PIN) == LOGIC_HIGH) {
+		g_highVotes++;
+	}
+	if (--g_votesLeft != 0) {
+		return;
+	}
+
+	occupied = (g_highVotes >= PIR_VOTE_MAJORITY);
+	if ((occupied != g_occupied) && (g_holdOff == 0)) {
+		g_occupied = occupied;
+		g_event = occupied ? PIR_OCCUPIED : PIR_CLEAR;
+		TRACE(TRACE_PIR_STATE, occupied);
+		g_holdOff = PIR_HOLD_OFF_TICKS;
+	}
+}
+
+uint8 PIR_isOccupied(void)
+{
+	return g_occupied;
+}
+
+void PIR_setMotionCallBack(void(*a_ptr)(void))
+{
+	g_CallBackMotion = a_ptr;
+}
+
+PIR_EventType PIR_getEvent(void)
+{
+	PIR_EventType event;
+
+	/*read and clear must not be split by the tick*/
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		event = g_event;
+		g_event = PIR_NO_EVENT;
+	}
+
+	return event;
 }
@@ -10,10 +10,50 @@
 
 #include "std_types.h"
 
-
+/*PIR output, HIGH while motion is seen (no external interrupt on this pin, see PIR_poll)*/
 #define PIR_PORT	PORTC_ID
 #define PIR_PIN		PIN2_ID
+
+/*
+ * Filter config (in PIR_tick calls):
+ * a pin level other than the reported state starts a vote over PIR_VOTE_SAMPLES ticks, the level seen on at least
+ * PIR_VOTE_MAJORITY of them wins. A new state is reported only after the reported one
+ * has lasted PIR_HOLD_OFF_TICKS.
+ */
+#define PIR_VOTE_SAMPLES	5
+#define PIR_VOTE_MAJORITY	3
+#define PIR_HOLD_OFF_TICKS	8
+
+typedef enum
+{
+	PIR_NO_EVENT,
+	PIR_OCCUPIED,	/*motion seen*/
+	PIR_CLEAR		/*no motion anymore*/
+} PIR_EventType;
+
 void PIR_init(void);
 
+/*raw level of the pin*/
 uint8 PIR_getState(void);
+
+/*filter step, to be called from a periodic timer interrupt*/
+void PIR_tick(void);
+
+/*
+ * edge check of the pin, to be called on every pass of the main loop (woken by every interrupt):
+ * reports a rising edge to the motion callback
+ */
+void PIR_poll(void);
+
+/*filtered state, TRUE while occupied*/
+uint8 PIR_isOccupied(void);
+
+/*last transition not read yet, PIR_NO_EVENT if none*/
+PIR_EventType PIR_getEvent(void);
+
+/*
+ * function called from PIR_poll on every rising edge (unfiltered),
+ * for the cases where reacting within a few ms matters more than ignoring noise
+ */
+void PIR_setMotionCallBack(void(*a_ptr)(void));
 #endif /* PIR_H_ */
@@ -9,6 +9,7 @@
 #include "common_macros.h"
 #include <avr/io.h>
 #include "gpio.h"
+#include "Timer.h"
 
 
 
@@ -22,7 +23,30 @@ void PWM_Timer0_Start(uint8 duty_cycle) {
 	 */
 	TCCR0 = (1 << WGM00) | (1 << WGM01) | (1 << COM01) | (1 << CS01) | (1 << CS00);
 
-	OCR0 = (uint8)(duty_cycle * 2.55);
-	GPIO_setupPinDirection(PORTB_ID, PIN3_ID, PIN_OUTPUT);/*set PB3/OC0 as output pin*/
+	PWM_setDuty(duty_cycle);
+	GPIO_SETUP_PIN_DIRECTION(PORTB_ID, PIN3_ID, PIN_OUTPUT);/*set PB3/OC0 as output pin*/
 }
 
+void PWM_setDuty(uint8 duty_cycle) {
+	if (duty_cycle > PWM_MAX_DUTY) {
+		duty_cycle = PWM_MAX_DUTY;
+	}
+
+	/* percent to compare value, rounded, integer only: 100% -> 255 */
+	OCR0 = (uint8)(((uint16)duty_cycle * PWM_TOP + (PWM_MAX_DUTY / 2)) / PWM_MAX_DUTY);
+
+	/*
+	 * fast PWM still gives a one tick pulse every period at OCR0 = 0,
+	 * so 0% disconnects OC0 and the pin stays at its (low) port value
+	 */
+	if (duty_cycle == 0) {
+		TCCR0 &= ~(1 << COM01);
+	} else {
+		TCCR0 |= (1 << COM01);
+	}
+}
+
+void PWM_setPeriodCallBack(void(*a_ptr)(void)) {
+	Timer_setCallBack(a_ptr, Timer_0);
+	TIMSK |= (1 << TOIE0); /* the overflow of the fast PWM counter marks every period start */
+}
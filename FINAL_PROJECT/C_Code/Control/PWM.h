@@ -9,6 +9,13 @@
 #define PWM_H_
 
 #include "std_types.h"
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define PWM_MAX_DUTY				100			/*duty cycle is given in percent*/
+#define PWM_TOP						255			/*8-bit fast PWM, OCR0 range*/
+#define PWM_PERIOD_HZ				488			/*F_CPU/64/256, rate of the period callback*/
+
 /*******************************************************************************
  *                             Function Prototypes                             *
  *******************************************************************************/
@@ -16,5 +23,18 @@
 /*Function to set the initial configurations for the PWM mode*/
 void PWM_Timer0_Start(uint8 duty_cycle);
 
+/*
+ * Function to change the duty cycle (0..100 %) while the PWM is running.
+ * OCR0 is double buffered in fast PWM mode, the new value takes effect at the
+ * end of the current period, so the output never gets a cut or stretched pulse.
+ */
+void PWM_setDuty(uint8 duty_cycle);
+
+/*
+ * Function to call a_ptr from the Timer0 overflow interrupt at the start of every PWM period
+ * (PWM_PERIOD_HZ), used as a background tick by the modules driving the PWM.
+ */
+void PWM_setPeriodCallBack(void(*a_ptr)(void));
+
 
 #endif /* PWM_H_ */
@@ -0,0 +1,127 @@
+/*
+ * adc.c
+ *
+ *  Free running, interrupt driven ADC sampling with averaging and a threshold callback,
+ *  running only between ADC_start() and ADC_stop().
+ */
+#include "adc.h"
+#include "common_macros.h"
+#include "gpio.h"
+#include "std_types.h"
+#include "trace.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+static void (*volatile g_CallBackThreshold)(void) = NULL_PTR;
+
+static uint16 g_sum = 0;						/*sum of the samples of the running average*/
+static uint8 g_count = 0;						/*samples in g_sum*/
+static volatile uint16 g_average = 0;
+
+static volatile uint8 g_armed = FALSE;
+static volatile uint16 g_threshold = ADC_MAXIMUM_VALUE;
+static volatile uint8 g_blanking = 0;			/*averages still to ignore*/
+
+/*One conversion done, the next one is already running (free running mode)*/
+ISR(ADC_vect)
+{
+	g_sum += ADC;
+
+	if (++g_count < ADC_AVERAGE_SAMPLES) {
+		return;
+	}
+
+	g_average = g_sum >> ADC_AVERAGE_SHIFT;
+	g_sum = 0;
+	g_count = 0;
+
+	if (g_armed) {
+		if (g_blanking != 0) {
+			g_blanking--;
+		} else if (g_average >= g_threshold) {
+			g_armed = FALSE;	/*one shot*/
+			TRACE(TRACE_STALL, g_average >> 2);
+			if (g_CallBackThreshold != NULL_PTR) {
+				(*g_CallBackThreshold)();
+			}
+		}
+	}
+}
+
+void ADC_init(const ADC_ConfigType *Config_Ptr)
+{
+	/*analog input, no pull-up*/
+	GPIO_setupPinDirection(PORTA_ID, Config_Ptr->channel, PIN_INPUT);
+	GPIO_writePin(PORTA_ID, Config_Ptr->channel, LOGIC_LOW);
+
+	g_sum = 0;
+	g_count = 0;
+	g_average = 0;
+	g_armed = FALSE;
+
+	/*reference and channel, right adjusted result*/
+	ADMUX = ((Config_Ptr->reference) << REFS0) | ((Config_Ptr->channel) & 0x07);
+
+	/*free running trigger source (ADTS2:0 = 0)*/
+	SFIOR &= ~((1 << ADTS2) | (1 << ADTS1) | (1 << ADTS0));
+
+	/*enable and prescaler only, the conversions run from ADC_start()*/
+	ADCSRA = (1 << ADEN) | (Config_Ptr->prescaler);
+}
+
+void ADC_start(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (!BIT_IS_SET(ADCSRA, ADATE)) {
+			/*new average, the samples taken before the stop are stale*/
+			g_sum = 0;
+			g_count = 0;
+
+			/*auto trigger, interrupt, start the first conversion (writing ADIF clears an old flag)*/
+			ADCSRA |= (1 << ADIF) | (1 << ADSC) | (1 << ADATE) | (1 << ADIE);
+		}
+	}
+}
+
+void ADC_stop(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		/*the conversion running ends without an interrupt, its flag is cleared by writing it*/
+		ADCSRA = (ADCSRA & ~((1 << ADATE) | (1 << ADIE))) | (1 << ADIF);
+		g_armed = FALSE;
+	}
+}
+
+uint16 ADC_getAverage(void)
+{
+	uint16 average;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		average = g_average;
+	}
+	return average;
+}
+
+void ADC_setThresholdCallBack(void(*a_ptr)(void))
+{
+	g_CallBackThreshold = a_ptr;
+}
+
+void ADC_armThreshold(uint16 threshold, uint8 blankingAverages)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_threshold = threshold;
+		g_blanking = blankingAverages;
+		g_armed = TRUE;
+	}
+}
+
+void ADC_disarmThreshold(void)
+{
+	g_armed = FALSE;
+}
@@ -0,0 +1,73 @@
+/*
+ * adc.h
+ *
+ *  Free running, interrupt driven ADC sampling with averaging and a threshold callback,
+ *  running only between ADC_start() and ADC_stop().
+ */
+
+#ifndef ADC_H_
+#define ADC_H_
+
+#include "std_types.h"
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define ADC_MAXIMUM_VALUE			1023
+#define ADC_AVERAGE_SHIFT			4							/*average of 2^4 = 16 samples*/
+#define ADC_AVERAGE_SAMPLES			(1 << ADC_AVERAGE_SHIFT)
+/*******************************************************************************
+ *                             Data Types Declarations                         *
+ *******************************************************************************/
+typedef enum
+{
+	ADC_AREF,			/*external AREF pin*/
+	ADC_AVCC,			/*AVCC with a capacitor on AREF*/
+	ADC_INTERNAL = 3	/*internal 2.56V*/
+} ADC_ReferenceType;
+
+typedef enum
+{
+	ADC_FCPU_2 = 1,
+	ADC_FCPU_4,
+	ADC_FCPU_8,
+	ADC_FCPU_16,
+	ADC_FCPU_32,
+	ADC_FCPU_64,
+	ADC_FCPU_128		/*62.5 kHz ADC clock at 8 MHz, about 4800 samples per second*/
+} ADC_PrescalerType;
+
+typedef struct
+{
+	ADC_ReferenceType reference;
+	ADC_PrescalerType prescaler;
+	uint8 channel;		/*ADC0..ADC7 (PA0..PA7)*/
+} ADC_ConfigType;
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*initialization, the ADC stays idle until ADC_start()*/
+void ADC_init(const ADC_ConfigType *Config_Ptr);
+
+/*start the free running conversions in the background, nothing if already running (safe from the ISRs)*/
+void ADC_start(void);
+
+/*stop the conversions and disarm the threshold callback, the last average is kept (safe from the ISRs)*/
+void ADC_stop(void);
+
+/*latest average of ADC_AVERAGE_SAMPLES samples*/
+uint16 ADC_getAverage(void);
+
+/*function called from the ADC interrupt when an average reaches the armed threshold*/
+void ADC_setThresholdCallBack(void(*a_ptr)(void));
+
+/*
+ * arm the threshold callback, it fires once when an average is >= threshold.
+ * the first blankingAverages averages are ignored (e.g. motor inrush current).
+ */
+void ADC_armThreshold(uint16 threshold, uint8 blankingAverages);
+
+/*disarm the threshold callback*/
+void ADC_disarmThreshold(void);
+
+#endif /* ADC_H_ */
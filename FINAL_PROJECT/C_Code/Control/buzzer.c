@@ -10,22 +10,150 @@
 #include "std_types.h"
 #include "gpio.h"
 #include "common_macros.h"
+#include "Timer.h"
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+/*Patterns, in flash*/
+static const Buzzer_StepType g_alarmPattern[] PROGMEM = {
+	BUZZER_TONE(2000, 250),
+	BUZZER_TONE(1000, 250),
+	BUZZER_LOOP
+};
+
+static const Buzzer_StepType g_chirpPattern[] PROGMEM = {
+	BUZZER_TONE(4000, 30),
+	BUZZER_END
+};
+
+static const Buzzer_StepType g_errorPattern[] PROGMEM = {
+	BUZZER_TONE(400, 150),
+	BUZZER_REST(100),
+	BUZZER_TONE(400, 150),
+	BUZZER_END
+};
+
+static const Buzzer_StepType * const g_patterns[BUZZER_NUM_OF_PATTERNS] PROGMEM = {
+	g_alarmPattern,
+	g_chirpPattern,
+	g_errorPattern
+};
+
+/*Pattern playing, owned by the Timer2 interrupt once started*/
+static const Buzzer_StepType *g_pattern = NULL_PTR;
+static uint8 g_step = 0;
+static uint16 g_ticksLeft = 0;
+static uint8 g_toneOn = FALSE;
+static volatile uint8 g_playing = FALSE;
+
+/*Timer2 stopped and the pin low*/
+static void Buzzer_silence(void)
+{
+	TCCR2 = 0;
+	TIMSK &= ~(1 << OCIE2);
+	GPIO_WRITE_PIN(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+	g_toneOn = FALSE;
+	g_playing = FALSE;
+}
+
+/*Load the next step of the pattern into Timer2*/
+static void Buzzer_nextStep(void)
+{
+	const Buzzer_StepType *step = &g_pattern[g_step];
+	uint8 kind = pgm_read_byte(&step->kind);
+
+	if (kind == BUZZER_STEP_LOOP) {
+		g_step = 0;
+		step = &g_pattern[0];
+		kind = pgm_read_byte(&step->kind);
+	}
+	if (kind == BUZZER_STEP_END) {
+		Buzzer_silence();
+		return;
+	}
+
+	g_ticksLeft = pgm_read_word(&step->ticks);
+	g_toneOn = (kind == BUZZER_STEP_TONE);
+	if (!g_toneOn) {
+		GPIO_WRITE_PIN(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+	}
+
+	/*restart the count, a compare value below the counter would otherwise wait for a wrap around*/
+	OCR2 = pgm_read_byte(&step->compare);
+	TCNT2 = 0;
+	g_step++;
+}
+
+/*Timer2 compare match: toggle the pin for a tone, and move on when the step is over*/
+static void Buzzer_tick(void)
+{
+	if (!g_playing) {
+		return;
+	}
+	if (g_toneOn) {
+		GPIO_PORT_REG(BUZZER_PORT_ID) ^= (1 << BUZZER_PIN_ID);
+	}
+	if (--g_ticksLeft == 0) {
+		Buzzer_nextStep();
+	}
+}
 
 /*Buzzer initialization (Pin direction and write 0 on it)*/
 void Buzzer_init(void)
 {
-	GPIO_setupPinDirection(BUZZER_PORT_ID, BUZZER_PIN_ID, PIN_OUTPUT);
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+	GPIO_SETUP_PIN_DIRECTION(BUZZER_PORT_ID, BUZZER_PIN_ID, PIN_OUTPUT);
+	GPIO_WRITE_PIN(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+	Timer_setCallBack(Buzzer_tick, Timer_2);
 }
 
 /*Turning the Buzzer on (Putting 1 on the pin)*/
 void Buzzer_on(void)
 {
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_HIGH);
+	Buzzer_stop();
+	GPIO_WRITE_PIN(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_HIGH);
 }
 
 /*Turning the Buzzer on (Putting 0 on the pin)*/
 void Buzzer_off(void)
 {
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+	Buzzer_stop();
+}
+
+void Buzzer_play(Buzzer_PatternType pattern)
+{
+	if (pattern >= BUZZER_NUM_OF_PATTERNS) {
+		return;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_pattern = (const Buzzer_StepType *)pgm_read_ptr(&g_patterns[pattern]);
+		g_step = 0;
+		g_playing = TRUE;
+		Buzzer_nextStep();
+
+		if (g_playing) {
+			/*
+			 * Timer2 programmed directly: the Timer driver writes Timer_ClockType straight into CS22:0,
+			 * which is right for Timer0/1 but not for the Timer2 prescaler table (F_CPU/64 is CS22 alone)
+			 */
+			TCCR2 = (1 << FOC2) | (1 << WGM21) | (1 << CS22);
+			TIFR = (1 << OCF2);
+			TIMSK |= (1 << OCIE2);
+		}
+	}
+}
+
+void Buzzer_stop(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Buzzer_silence();
+	}
+}
+
+uint8 Buzzer_isPlaying(void)
+{
+	return g_playing;
 }
@@ -14,6 +14,51 @@
  *******************************************************************************/
 #define BUZZER_PORT_ID		PORTC_ID
 #define BUZZER_PIN_ID		PIN7_ID
+
+/*
+ * Tone generator: Timer2 in CTC mode at F_CPU/64 toggles the pin on every compare match,
+ * so a tone of f Hz needs OCR2 = F_CPU/(2*64*f) - 1 (about 245 Hz .. 62 kHz at 8 MHz).
+ * Rests keep the timer running at BUZZER_REST_HZ without toggling the pin, to time them.
+ */
+#define BUZZER_TIMER_CLOCK_HZ	(F_CPU / 64)
+#define BUZZER_REST_HZ			1000
+
+/*
+ * Pattern steps, built at compile time so the interrupt only loads them:
+ * BUZZER_TONE(f, ms) plays f Hz for ms, BUZZER_REST(ms) is silent for ms,
+ * a pattern ends with BUZZER_END (stop) or BUZZER_LOOP (play again from the start).
+ */
+#define BUZZER_TONE(FREQ,MS)	{(uint8)((BUZZER_TIMER_CLOCK_HZ / (2UL * (FREQ))) - 1), \
+								 (uint16)((2UL * (FREQ) * (MS)) / 1000), BUZZER_STEP_TONE}
+#define BUZZER_REST(MS)			{(uint8)((BUZZER_TIMER_CLOCK_HZ / BUZZER_REST_HZ) - 1), \
+								 (uint16)(MS), BUZZER_STEP_REST}
+#define BUZZER_END				{0, 0, BUZZER_STEP_END}
+#define BUZZER_LOOP				{0, 0, BUZZER_STEP_LOOP}
+/*******************************************************************************
+ *                             Data Types Declarations                         *
+ *******************************************************************************/
+typedef enum
+{
+	BUZZER_ALARM,		/*two tone siren, repeats until Buzzer_stop*/
+	BUZZER_CHIRP,		/*short high beep, feedback*/
+	BUZZER_ERROR,		/*two low beeps*/
+	BUZZER_NUM_OF_PATTERNS
+} Buzzer_PatternType;
+
+typedef enum
+{
+	BUZZER_STEP_REST,
+	BUZZER_STEP_TONE,
+	BUZZER_STEP_END,
+	BUZZER_STEP_LOOP
+} Buzzer_StepKindType;
+
+typedef struct
+{
+	uint8 compare;		/*OCR2 value*/
+	uint16 ticks;		/*compare matches until the next step*/
+	uint8 kind;			/*Buzzer_StepKindType*/
+} Buzzer_StepType;
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
@@ -27,4 +72,13 @@ void Buzzer_on(void);
 /*function for turning the buzzer off*/
 void Buzzer_off(void);
 
+/*function for playing a pattern in the background (replaces the one playing)*/
+void Buzzer_play(Buzzer_PatternType pattern);
+
+/*function for stopping the pattern playing*/
+void Buzzer_stop(void);
+
+/*function returning TRUE while a pattern is playing*/
+uint8 Buzzer_isPlaying(void);
+
 #endif /* BUZZER_H_ */
@@ -0,0 +1,116 @@
+/*
+ * door_position.c
+ *
+ *  Door position tracking from an encoder and two end stop (limit) switches.
+ */
+#include "door_position.h"
+#include "common_macros.h"
+#include "gpio.h"
+#include "motor.h"
+#include "std_types.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+/*Position in encoder counts, written by the encoder interrupt*/
+static volatile sint16 g_position = DOOR_POSITION_CLOSED;
+
+/*Last driven direction, pulses while coasting keep counting this way*/
+static volatile DcMotor_State g_lastDirection = STOP;
+
+/*Encoder pulses since the start of the move (saturating), 0 = no encoder seen yet*/
+static volatile uint8 g_travelPulses = 0;
+
+void DoorPosition_init(void)
+{
+	GPIO_SETUP_PIN_DIRECTION(DOOR_ENCODER_PORT_ID, DOOR_ENCODER_PIN_ID, PIN_INPUT);
+	GPIO_SETUP_PIN_DIRECTION(DOOR_CLOSED_SWITCH_PORT_ID, DOOR_CLOSED_SWITCH_PIN_ID, PIN_INPUT);
+	GPIO_SETUP_PIN_DIRECTION(DOOR_OPEN_SWITCH_PORT_ID, DOOR_OPEN_SWITCH_PIN_ID, PIN_INPUT);
+	GPIO_WRITE_PIN(DOOR_ENCODER_PORT_ID, DOOR_ENCODER_PIN_ID, LOGIC_HIGH);				/*pull-up, no counts if not wired*/
+	GPIO_WRITE_PIN(DOOR_CLOSED_SWITCH_PORT_ID, DOOR_CLOSED_SWITCH_PIN_ID, LOGIC_HIGH);	/*pull-up*/
+	GPIO_WRITE_PIN(DOOR_OPEN_SWITCH_PORT_ID, DOOR_OPEN_SWITCH_PIN_ID, LOGIC_HIGH);		/*pull-up*/
+
+	g_position = DOOR_POSITION_CLOSED;
+	g_lastDirection = STOP;
+	g_travelPulses = 0;
+
+	/*INT0 on the rising edge of the encoder*/
+	MCUCR |= (1 << ISC01) | (1 << ISC00);
+	SET_BIT(GIFR, INTF0);
+	SET_BIT(GICR, INT0);
+}
+
+/*One encoder pulse, count it in the direction the motor is (or was last) driven*/
+ISR(INT0_vect)
+{
+	DcMotor_State state = DcMotor_getState();
+
+	if (g_travelPulses != 0xFF) {
+		g_travelPulses++;
+	}
+	if (state == CW || state == A_CW) {
+		g_lastDirection = state;
+	}
+
+	if (g_lastDirection == CW) {
+		if (g_position < DOOR_POSITION_OPEN) {
+			g_position++;
+		}
+	} else if (g_lastDirection == A_CW) {
+		if (g_position > DOOR_POSITION_CLOSED) {
+			g_position--;
+		}
+	}
+}
+
+sint16 DoorPosition_get(void)
+{
+	sint16 position;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		position = g_position;
+	}
+	return position;
+}
+
+void DoorPosition_startTravel(void)
+{
+	g_travelPulses = 0;
+}
+
+uint8 DoorPosition_isTracking(void)
+{
+	return (g_travelPulses != 0);
+}
+
+uint8 DoorPosition_atEndStop(DcMotor_State direction)
+{
+	if (direction == CW) {
+		if (GPIO_READ_PIN(DOOR_OPEN_SWITCH_PORT_ID, DOOR_OPEN_SWITCH_PIN_ID) == LOGIC_LOW) {
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				g_position = DOOR_POSITION_OPEN;
+			}
+			return TRUE;
+		}
+		return DoorPosition_isTracking() && (DoorPosition_get() >= DOOR_POSITION_OPEN);
+	} else if (direction == A_CW) {
+		if (GPIO_READ_PIN(DOOR_CLOSED_SWITCH_PORT_ID, DOOR_CLOSED_SWITCH_PIN_ID) == LOGIC_LOW) {
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				g_position = DOOR_POSITION_CLOSED;
+			}
+			return TRUE;
+		}
+		return DoorPosition_isTracking() && (DoorPosition_get() <= DOOR_POSITION_CLOSED);
+	}
+	return FALSE;
+}
+
+uint16 DoorPosition_distanceTo(sint16 target)
+{
+	sint16 position = DoorPosition_get();
+
+	return (target > position) ? (uint16)(target - position) : (uint16)(position - target);
+}
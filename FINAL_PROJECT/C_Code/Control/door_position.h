@@ -0,0 +1,59 @@
+/*
+ * door_position.h
+ *
+ *  Door position tracking from an encoder and two end stop (limit) switches.
+ *  Position 0 is closed, DOOR_POSITION_OPEN is fully open.
+ *  All three inputs have their pull-ups on: without the sensors (Proteus schematic) no count and
+ *  no end stop is ever seen. The count is only trusted on a move where the encoder gave pulses,
+ *  so such a move is never taken as arrived and ends on the travel timeout of the application.
+ */
+
+#ifndef DOOR_POSITION_H_
+#define DOOR_POSITION_H_
+
+#include "std_types.h"
+#include "motor.h"
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/*Encoder pulse input, one count per pulse, the direction comes from the motor (INT0)*/
+#define DOOR_ENCODER_PORT_ID		PORTD_ID
+#define DOOR_ENCODER_PIN_ID			PIN2_ID
+
+/*End stop switches, active low with the internal pull-ups*/
+#define DOOR_CLOSED_SWITCH_PORT_ID	PORTC_ID
+#define DOOR_CLOSED_SWITCH_PIN_ID	PIN3_ID
+#define DOOR_OPEN_SWITCH_PORT_ID	PORTC_ID
+#define DOOR_OPEN_SWITCH_PIN_ID		PIN4_ID
+
+/*Travel in encoder counts*/
+#define DOOR_POSITION_CLOSED		0
+#define DOOR_POSITION_OPEN			600
+#define DOOR_APPROACH_DISTANCE		60		/*slow down this many counts before the end stop*/
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*initialization, the door is assumed closed until an end stop says otherwise*/
+void DoorPosition_init(void);
+
+/*current position in encoder counts*/
+sint16 DoorPosition_get(void);
+
+/*start of a move, the encoder count is trusted again only once it gives a pulse*/
+void DoorPosition_startTravel(void);
+
+/*TRUE once the encoder gave a pulse since DoorPosition_startTravel*/
+uint8 DoorPosition_isTracking(void);
+
+/*
+ * TRUE when the door is at the end stop of the given direction (CW = open, A_CW = closed),
+ * either from its switch or from the encoder count (only while tracking). A pressed switch also
+ * re-zeroes the count.
+ */
+uint8 DoorPosition_atEndStop(DcMotor_State direction);
+
+/*counts between the door and the target position*/
+uint16 DoorPosition_distanceTo(sint16 target);
+
+#endif /* DOOR_POSITION_H_ */
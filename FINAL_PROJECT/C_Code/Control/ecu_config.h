@@ -0,0 +1,27 @@
+/*
+ * ecu_config.h
+ *
+ *  Compile-time configuration of the Control ECU for the shared modules of ../Common
+ *  (trace, timestamp, latency, cpu_load, stack_monitor, boot_profile), built with this directory in the include path.
+ */
+
+#ifndef ECU_CONFIG_H_
+#define ECU_CONFIG_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define ECU_ID                         'C'      /* ECU id in the dump frames */
+
+/* Timer1 ticks in CTC mode (timerCallBackRuntime), the time base of the measurements */
+#define ECU_TIMESTAMP_TOP              2930     /* TCNT1 counts 0..TOP (compare value of the tick) */
+#define ECU_TIMESTAMP_PERIOD_FLAG      OCF1A    /* TIFR flag raised at the end of a period */
+
+#define ECU_STACKMON_SCAN_STEP         32       /* Paint bytes scanned per Timer1 period (375ms) */
+
+#define ECU_PHASES                     4        /* phaseSwitches 0..3 */
+
+#define ECU_LATENCY_FIRST              LATENCY_AUTH_MOTOR    /* Histograms measured here (see latency.h) */
+#define ECU_LATENCY_LAST               LATENCY_CLEAR_CLOSE
+
+#endif /* ECU_CONFIG_H_ */
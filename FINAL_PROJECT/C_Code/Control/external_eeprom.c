@@ -11,9 +11,12 @@
  *******************************************************************************/
 #include "external_eeprom.h"
 #include "I2C.h"
+#include "trace.h"
 
 uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
 {
+	TRACE(TRACE_EEPROM_WRITE, u16addr);
+
 	/* Send the Start Bit */
 	I2C_start();
     if (I2C_getStatus() != I2C_START)
@@ -37,12 +40,15 @@ uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
 
     /* Send the Stop Bit */
     I2C_stop();
+    TRACE(TRACE_EEPROM_DONE, 0);
 	
     return SUCCESS;
 }
 
 uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
 {
+	TRACE(TRACE_EEPROM_READ, u16addr);
+
 	/* Send the Start Bit */
 	I2C_start();
     if (I2C_getStatus() != I2C_START)
@@ -77,6 +83,7 @@ uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
 
     /* Send the Stop Bit */
     I2C_stop();
+    TRACE(TRACE_EEPROM_DONE, 0);
 
     return SUCCESS;
 }
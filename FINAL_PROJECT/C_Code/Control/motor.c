@@ -9,45 +9,78 @@
 #include "PWM.h"
 #include "std_types.h"
 #include <avr/io.h>
+#include <util/atomic.h>
 
 /*Important global variable that indicated whether the fan is turned on or off*/
 uint8 fanState;
 
+/*State and speed currently applied to the H-bridge*/
+static volatile DcMotor_State g_motorState = STOP;
+static volatile uint8 g_motorSpeed = 0;
+
 /*	Motor initialization, IN1, IN2, ENABLE pins are output
  *  initially, the fan state is OFF*/
 void DcMotor_Init(void)
 {
-	GPIO_setupPinDirection(MOTOR_ENABLE_PORT_ID, MOTOR_ENABLE_PIN_ID, PIN_OUTPUT);
-	GPIO_setupPinDirection(MOTOR_IN1_PORT_ID, MOTOR_IN1_PIN_ID, PIN_OUTPUT);
-	GPIO_setupPinDirection(MOTOR_IN2_PORT_ID, MOTOR_IN2_PIN_ID, PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(MOTOR_ENABLE_PORT_ID, MOTOR_ENABLE_PIN_ID, PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(MOTOR_IN1_PORT_ID, MOTOR_IN1_PIN_ID, PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(MOTOR_IN2_PORT_ID, MOTOR_IN2_PIN_ID, PIN_OUTPUT);
 
-	GPIO_writePin(MOTOR_IN1_PORT_ID, MOTOR_IN1_PIN_ID, LOGIC_LOW);
-	GPIO_writePin(MOTOR_IN2_PORT_ID, MOTOR_IN2_PIN_ID, LOGIC_LOW);
+	GPIO_WRITE_PORT_MASKED(MOTOR_IN1_PORT_ID, MOTOR_IN_MASK, 0);
 
 	fanState = LOGIC_LOW;
+	g_motorState = STOP;
+	g_motorSpeed = 0;
 }
 
-/*checking the state of motor, and it's rotation speed*/
+/*checking the state of motor, and it's rotation speed
+ * both H-bridge inputs change with one store, so the bridge never passes through an invalid state*/
 void DcMotor_Rotate(DcMotor_State state, uint8 speed)
 {
-	switch (state) {
-		case CW:
-			fanState = LOGIC_HIGH;
-			GPIO_writePin(MOTOR_IN1_PORT_ID, MOTOR_IN1_PIN_ID, LOGIC_LOW);
-			GPIO_writePin(MOTOR_IN2_PORT_ID, MOTOR_IN2_PIN_ID, LOGIC_HIGH);
-			break;
-		case A_CW:
-			fanState = LOGIC_HIGH;
-			GPIO_writePin(MOTOR_IN1_PORT_ID, MOTOR_IN1_PIN_ID, LOGIC_HIGH);
-			GPIO_writePin(MOTOR_IN2_PORT_ID, MOTOR_IN2_PIN_ID, LOGIC_LOW);
-			break;
-		case STOP:
-			fanState = LOGIC_LOW;
-			GPIO_writePin(MOTOR_IN1_PORT_ID, MOTOR_IN1_PIN_ID, LOGIC_LOW);
-			GPIO_writePin(MOTOR_IN2_PORT_ID, MOTOR_IN2_PIN_ID, LOGIC_LOW);
-			break;
+	if (state == STOP) {
+		speed = 0;
 	}
 
-//	/*putting the speed to the duty cycle*/
-//	PWM_Timer0_Start(speed);
+	/*called from the main loop and from interrupts, the compare and update must not be split*/
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (state != g_motorState) {
+			switch (state) {
+				case CW:
+					fanState = LOGIC_HIGH;
+					GPIO_WRITE_PORT_MASKED(MOTOR_IN1_PORT_ID, MOTOR_IN_MASK, MOTOR_IN2_BIT);
+					break;
+				case A_CW:
+					fanState = LOGIC_HIGH;
+					GPIO_WRITE_PORT_MASKED(MOTOR_IN1_PORT_ID, MOTOR_IN_MASK, MOTOR_IN1_BIT);
+					break;
+				case STOP:
+					fanState = LOGIC_LOW;
+					GPIO_WRITE_PORT_MASKED(MOTOR_IN1_PORT_ID, MOTOR_IN_MASK, 0);
+					break;
+				case BRAKE:
+					fanState = LOGIC_LOW;
+					GPIO_WRITE_PORT_MASKED(MOTOR_IN1_PORT_ID, MOTOR_IN_MASK, MOTOR_IN_MASK);
+					break;
+			}
+			g_motorState = state;
+		}
+
+		if (speed != g_motorSpeed) {
+			/*putting the speed to the duty cycle*/
+			PWM_setDuty(speed);
+			g_motorSpeed = speed;
+		}
+	}
+}
+
+/*the enable must be on for the shorted inputs to brake the motor*/
+void DcMotor_Brake(void)
+{
+	DcMotor_Rotate(BRAKE, PWM_MAX_DUTY);
+}
+
+DcMotor_State DcMotor_getState(void)
+{
+	return g_motorState;
 }
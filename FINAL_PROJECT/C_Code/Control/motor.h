@@ -20,7 +20,8 @@ typedef enum
 {
     CW,
     A_CW,
-    STOP
+    STOP,		/*both inputs low, the motor coasts*/
+    BRAKE		/*both inputs high, the motor is shorted and stops fast*/
 } DcMotor_State;
 
 /*******************************************************************************
@@ -33,11 +34,29 @@ typedef enum
 #define MOTOR_IN2_PIN_ID			PIN7_ID
 #define MOTOR_ENABLE_PIN_ID			PIN3_ID
 
+/* IN1 and IN2 are updated together with one store, so they must share a port */
+#if (MOTOR_IN1_PORT_ID != MOTOR_IN2_PORT_ID)
+#error "MOTOR_IN1 and MOTOR_IN2 must be on the same port"
+#endif
+#define MOTOR_IN1_BIT				(1 << MOTOR_IN1_PIN_ID)
+#define MOTOR_IN2_BIT				(1 << MOTOR_IN2_PIN_ID)
+#define MOTOR_IN_MASK				(MOTOR_IN1_BIT | MOTOR_IN2_BIT)
+
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
 
 void DcMotor_Init(void);
 
+/*
+ * Only touches the hardware on a change: the H-bridge inputs when the state changes,
+ * the duty cycle when the speed changes, so it can be called on every pass or tick.
+ */
 void DcMotor_Rotate(DcMotor_State state, uint8 speed);
+
+/*stop fast by shorting the motor (dynamic braking), the bridge stays in brake until the next command*/
+void DcMotor_Brake(void);
+
+/*direction the motor is currently driven in (STOP when not driven)*/
+DcMotor_State DcMotor_getState(void);
 #endif /* MOTOR_H_ */
@@ -0,0 +1,183 @@
+/*
+ * motor_ramp.c
+ *
+ *  Trapezoidal soft-start / soft-stop for the door motor.
+ */
+#include "motor_ramp.h"
+#include "adc.h"
+#include "motor.h"
+#include "PWM.h"
+#include "std_types.h"
+#include "trace.h"
+#include <util/atomic.h>
+
+/*Ramp state, written by the application inside atomic blocks and by the PWM period tick*/
+static volatile MotorRamp_StateType g_rampState = MOTOR_RAMP_IDLE;
+static volatile DcMotor_State g_direction = STOP;
+static volatile uint16 g_duty = 0;				/*current duty, 8.8 fixed point percent*/
+static volatile uint16 g_cruiseDuty = 0;
+static volatile uint16 g_accelStep = 0;			/*duty added/removed every tick*/
+static volatile uint16 g_decelStep = 0;
+static volatile uint16 g_cruiseTicks = 0;		/*0 = cruise until stopped*/
+static volatile uint16 g_ticks = 0;
+
+/*Move requested the other way while running, started once the motor has stopped*/
+static volatile uint8 g_pending = FALSE;
+static volatile DcMotor_State g_pendingDirection = STOP;
+static volatile uint16 g_pendingDecelStep = 0;
+
+/*number of PWM periods in the given time*/
+static uint16 MotorRamp_msToTicks(uint16 time)
+{
+	return (uint16)(((uint32)time * PWM_PERIOD_HZ) / 1000);
+}
+
+/*duty change per tick to cover the full duty range in the given time, never 0*/
+static uint16 MotorRamp_stepOf(uint16 duty, uint16 time)
+{
+	uint16 ticks = MotorRamp_msToTicks(time);
+
+	if (ticks == 0) {
+		return duty;	/*no ramp, jump in one tick*/
+	}
+	duty /= ticks;
+	return (duty == 0) ? 1 : duty;
+}
+
+/*PWM period tick, advances the ramp by one step*/
+static void MotorRamp_tick(void)
+{
+	switch (g_rampState) {
+		case MOTOR_RAMP_ACCEL:
+			if (g_duty + g_accelStep < g_cruiseDuty) {
+				g_duty += g_accelStep;
+			} else if (g_duty > g_cruiseDuty + g_decelStep) {
+				g_duty -= g_decelStep;	/*new profile is slower, slow down to it*/
+			} else {
+				g_duty = g_cruiseDuty;
+				g_ticks = g_cruiseTicks;
+				g_rampState = MOTOR_RAMP_CRUISE;
+			}
+			break;
+
+		case MOTOR_RAMP_CRUISE:
+			if (g_cruiseTicks != 0) {
+				if (g_ticks != 0) {
+					g_ticks--;
+				} else {
+					g_rampState = MOTOR_RAMP_DECEL;
+				}
+			}
+			return;	/*duty unchanged*/
+
+		case MOTOR_RAMP_DECEL:
+			if (g_duty > g_decelStep) {
+				g_duty -= g_decelStep;
+			} else {
+				g_duty = 0;
+				if (g_pending) {
+					/*stopped, now turn the other way*/
+					g_pending = FALSE;
+					g_direction = g_pendingDirection;
+					g_decelStep = g_pendingDecelStep;
+					DcMotor_Rotate(g_direction, 0);
+					g_rampState = MOTOR_RAMP_ACCEL;
+				} else {
+					DcMotor_Rotate(STOP, 0);
+					ADC_stop();		/*no current to watch*/
+					g_direction = STOP;
+					g_rampState = MOTOR_RAMP_IDLE;
+					TRACE(TRACE_MOTOR_IDLE, 0);
+					return;
+				}
+			}
+			break;
+
+		case MOTOR_RAMP_IDLE:
+			return;
+	}
+
+	DcMotor_Rotate(g_direction, (uint8)(g_duty >> MOTOR_RAMP_FRACTION_BITS));
+}
+
+void MotorRamp_init(void)
+{
+	g_rampState = MOTOR_RAMP_IDLE;
+	g_direction = STOP;
+	g_duty = 0;
+	g_pending = FALSE;
+	PWM_setPeriodCallBack(MotorRamp_tick);
+}
+
+void MotorRamp_start(DcMotor_State direction, const MotorRamp_ProfileType *profile)
+{
+	/*the divisions are done here, so the tick only adds and compares*/
+	uint16 cruiseDuty = (uint16)profile->cruiseDuty << MOTOR_RAMP_FRACTION_BITS;
+	uint16 accelStep = MotorRamp_stepOf(cruiseDuty, profile->accelTime);
+	uint16 decelStep = MotorRamp_stepOf(cruiseDuty, profile->decelTime);
+	uint16 cruiseTicks = MotorRamp_msToTicks(profile->cruiseTime);
+
+	if (direction == STOP) {
+		MotorRamp_stop();
+		return;
+	}
+
+	TRACE(TRACE_MOTOR_START, direction);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_cruiseDuty = cruiseDuty;
+		g_accelStep = accelStep;
+		g_cruiseTicks = cruiseTicks;
+
+		if (g_rampState == MOTOR_RAMP_IDLE || g_direction == direction) {
+			/*from stop, or speed up again from the current duty*/
+			if (g_rampState == MOTOR_RAMP_IDLE) {
+				g_duty = 0;
+				g_direction = direction;
+				DcMotor_Rotate(direction, 0);
+				ADC_start();	/*watch the current while the motor is driven*/
+			}
+			g_pending = FALSE;
+			g_decelStep = decelStep;
+			g_rampState = MOTOR_RAMP_ACCEL;
+		} else {
+			/*running the other way, stop with the old deceleration then reverse*/
+			g_pending = TRUE;
+			g_pendingDirection = direction;
+			g_pendingDecelStep = decelStep;
+			g_rampState = MOTOR_RAMP_DECEL;
+		}
+	}
+}
+
+void MotorRamp_stop(void)
+{
+	TRACE(TRACE_MOTOR_STOP, 0);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_pending = FALSE;
+		if (g_rampState != MOTOR_RAMP_IDLE) {
+			g_rampState = MOTOR_RAMP_DECEL;
+		}
+	}
+}
+
+void MotorRamp_halt(void)
+{
+	TRACE(TRACE_MOTOR_HALT, 0);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_pending = FALSE;
+		g_duty = 0;
+		g_direction = STOP;
+		g_rampState = MOTOR_RAMP_IDLE;
+		DcMotor_Brake();
+		ADC_stop();
+	}
+}
+
+MotorRamp_StateType MotorRamp_getState(void)
+{
+	return g_rampState;
+}
@@ -0,0 +1,65 @@
+/*
+ * motor_ramp.h
+ *
+ *  Trapezoidal soft-start / soft-stop for the door motor.
+ *  The ramp runs from the PWM period interrupt, the application only starts and stops it.
+ *  The motor current is sampled (ADC) only while the ramp drives the motor.
+ */
+
+#ifndef MOTOR_RAMP_H_
+#define MOTOR_RAMP_H_
+
+#include "std_types.h"
+#include "motor.h"
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define MOTOR_RAMP_FRACTION_BITS	8			/*duty is kept in 8.8 fixed point between two ticks*/
+/*******************************************************************************
+ *                             Data Types Declarations                         *
+ *******************************************************************************/
+typedef enum
+{
+	MOTOR_RAMP_IDLE,		/*motor stopped*/
+	MOTOR_RAMP_ACCEL,		/*duty moving to the cruise duty (down with the decel step if above it)*/
+	MOTOR_RAMP_CRUISE,		/*running at the cruise duty*/
+	MOTOR_RAMP_DECEL		/*duty falling to zero, the motor stops at the end*/
+} MotorRamp_StateType;
+
+/*
+ * Speed profile, the times are in ms:
+ * accelTime  : from stopped to cruiseDuty
+ * cruiseTime : time spent at cruiseDuty before decelerating on its own (0 = until MotorRamp_stop)
+ * decelTime  : from cruiseDuty to stopped
+ */
+typedef struct
+{
+	uint8 cruiseDuty;
+	uint16 accelTime;
+	uint16 cruiseTime;
+	uint16 decelTime;
+} MotorRamp_ProfileType;
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*initialization, the PWM (Timer0) must already be started*/
+void MotorRamp_init(void);
+
+/*
+ * start moving in the given direction with the given profile.
+ * if the motor is running the other way it decelerates first then starts the new move,
+ * if it is already running this way it continues from its current speed.
+ */
+void MotorRamp_start(DcMotor_State direction, const MotorRamp_ProfileType *profile);
+
+/*decelerate to a stop with the deceleration of the current profile*/
+void MotorRamp_stop(void);
+
+/*stop right now without ramping down and brake the motor (end stop reached, stall)*/
+void MotorRamp_halt(void);
+
+/*current phase of the ramp*/
+MotorRamp_StateType MotorRamp_getState(void);
+
+#endif /* MOTOR_RAMP_H_ */
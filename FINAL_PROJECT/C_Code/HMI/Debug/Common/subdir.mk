@@ -0,0 +1,48 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+C_SRCS += \
+../../Common/Timer.c \
+../../Common/UART.c \
+../../Common/boot_profile.c \
+../../Common/cpu_load.c \
+../../Common/gpio.c \
+../../Common/latency.c \
+../../Common/stack_monitor.c \
+../../Common/timestamp.c \
+../../Common/trace.c 
+
+OBJS += \
+./Common/Timer.o \
+./Common/UART.o \
+./Common/boot_profile.o \
+./Common/cpu_load.o \
+./Common/gpio.o \
+./Common/latency.o \
+./Common/stack_monitor.o \
+./Common/timestamp.o \
+./Common/trace.o 
+
+C_DEPS += \
+./Common/Timer.d \
+./Common/UART.d \
+./Common/boot_profile.d \
+./Common/cpu_load.d \
+./Common/gpio.d \
+./Common/latency.d \
+./Common/stack_monitor.d \
+./Common/timestamp.d \
+./Common/trace.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+Common/%.o: ../../Common/%.c Common/subdir.mk
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -I".." -I"../../Common" -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -5,26 +5,20 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../LCD.c \
+../LCD_hw.c \
 ../Main_App_HMI.c \
-../Timer.c \
-../UART.c \
-../gpio.c \
 ../keypad.c 
 
 OBJS += \
 ./LCD.o \
+./LCD_hw.o \
 ./Main_App_HMI.o \
-./Timer.o \
-./UART.o \
-./gpio.o \
 ./keypad.o 
 
 C_DEPS += \
 ./LCD.d \
+./LCD_hw.d \
 ./Main_App_HMI.d \
-./Timer.d \
-./UART.d \
-./gpio.d \
 ./keypad.d 
 
 
@@ -32,7 +26,7 @@ C_DEPS += \
 %.o: ../%.c subdir.mk
 	@echo 'Building file: $<'
 	@echo 'Invoking: AVR Compiler'
-	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	avr-gcc -I"../../Common" -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -33,6 +33,10 @@
  *
  * 5. Displaying Numbers:
  *    - `LCD_intgerToString()`: Converts an integer to a string and displays it on the LCD.
+ *    - `LCD_putU16()`, `LCD_putU32()`, `LCD_putS32()`: Display a number with an optional fixed width and zero/space padding.
+ *    - `LCD_putFixed()`: Displays a scaled integer as a fixed point number (e.g. 1234 with 2 fraction digits -> "12.34").
+ *    - Digits are produced by repeated subtraction of powers of ten and sent straight to the LCD,
+ *      no libc (itoa/printf), no heap and no string buffer on the stack.
  *
  * 6. Clearing the Screen:
  *    - `LCD_ClearScreen()`: Sends the command to clear the LCD display.
@@ -44,138 +48,44 @@
  *
  * note: The driver assumes that the LCD data and control pins are predefined in `LCD.h`. This driver supports both 4-bit and 8-bit modes depending on the configuration.
  *
+ * The bus level part (`LCD_init()`, `LCD_SendCommand()`, `LCD_SendCharacter()`) is in LCD_hw.c,
+ * everything in this file is built on those three functions only.
+ *
  */
 
 
 #include "LCD.h"
 #include"gpio.h"
 #include"std_types.h"
-#include <util/delay.h>
 #include "common_macros.h"
-#include <stdlib.h>
+#include "trace.h"
+#include <avr/pgmspace.h>
 
-/*LCD initialization*/
-void LCD_init(void)
-{
-	/*Setting the direction of the main pins as OUTPUT*/
-	GPIO_setupPinDirection(LCD_RS_PORT, LCD_RS_PIN, 		PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_Enable_PORT, LCD_Enable_PIN, PIN_OUTPUT);
-
-	/* LCD Power ON delay (always > 15ms) */
-	_delay_ms(15);
-#if(LDC_MODE == 8)
-	GPIO_setupPortDirection(LCD_Command_Data_PORT, PORT_OUTPUT);
-#else
-
-	GPIO_setupPinDirection(LCD_Command_Data_PORT, LCD_Command_Data_FIRST_PIN, 	PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_Command_Data_PORT, LCD_Command_Data_SECOND_PIN, 	PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_Command_Data_PORT, LCD_Command_Data_THIRD_PIN, 	PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_Command_Data_PORT, LCD_Command_Data_FOURTH_PIN,  PIN_OUTPUT);
-#endif
-
-
-	/*Setting LCD modes & initial Setup*/
-#if(LDC_MODE == 8)
-	LCD_SendCommand(LCD_TWO_LINES_EIGHT_BITS_MODE);
-#else
-	/* Send for 4 bit initialization of LCD  */
-	LCD_SendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
-	LCD_SendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2);
-	LCD_SendCommand(LCD_TWO_LINES_FOUR_BITS_MODE);
-#endif
-	LCD_SendCommand(LCD_CURSOR_OFF);
-	LCD_SendCommand(LCD_CLEAR_COMMAND);
-}
+/*******************************************************************************
+ *                      Private Data & Functions Prototypes                    *
+ *******************************************************************************/
 
-/*Sending required commands*/
-void LCD_SendCommand(uint8 command)
+/*Powers of ten used to extract the decimal digits without any division (kept in flash)*/
+static const uint32 LCD_powersOfTen[LCD_MAX_DIGITS] PROGMEM =
 {
-#if(LDC_MODE == 8)
-	/*following this scenario from the Data Sheet Timing Diagram*/
-	GPIO_writePin(LCD_RS_PORT, LCD_RS_PIN, LOGIC_LOW);
-	_delay_ms(1);
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
-	_delay_ms(1);
-	GPIO_writePort(LCD_Command_Data_PORT, command);
-	_delay_ms(1);
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
-	_delay_ms(1);
-#else
-	GPIO_writePin(LCD_RS_PORT, LCD_RS_PIN, LOGIC_LOW);
-
-	_delay_ms(1);
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
-	_delay_ms(1);
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_FIRST_PIN, 	GET_VAR_BIT(command,4));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_SECOND_PIN, 	GET_VAR_BIT(command,5));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_THIRD_PIN, 	GET_VAR_BIT(command,6));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_FOURTH_PIN,   GET_VAR_BIT(command,7));
-	_delay_ms(1);
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
-	_delay_ms(1);
-
-
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
-	_delay_ms(1);
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_FIRST_PIN, 	GET_VAR_BIT(command,0));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_SECOND_PIN, 	GET_VAR_BIT(command,1));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_THIRD_PIN, 	GET_VAR_BIT(command,2));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_FOURTH_PIN,   GET_VAR_BIT(command,3));
-	_delay_ms(1);
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
-	_delay_ms(1);
-#endif
-}
+	1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+	10000UL, 1000UL, 100UL, 10UL, 1UL
+};
 
-/*Sending a specific character*/
-void LCD_SendCharacter(uint8 character)
-{
-#if(LDC_MODE == 8)
-	/*following this scenario from the Data Sheet Timing Diagram*/
-	GPIO_writePin(LCD_RS_PORT, LCD_RS_PIN, LOGIC_HIGH);
-	_delay_ms(1);
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
-	_delay_ms(1);
-	GPIO_writePort(LCD_Command_Data_PORT, character);
-	_delay_ms(1);
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
-	_delay_ms(1);
-#else
-	GPIO_writePin(LCD_RS_PORT, LCD_RS_PIN, LOGIC_HIGH);
-
-	_delay_ms(1);
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
-	_delay_ms(1);
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_FIRST_PIN, 	GET_VAR_BIT(character,4));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_SECOND_PIN, 	GET_VAR_BIT(character,5));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_THIRD_PIN, 	GET_VAR_BIT(character,6));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_FOURTH_PIN,   GET_VAR_BIT(character,7));
-	_delay_ms(1);
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
-	_delay_ms(1);
-
-
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
-	_delay_ms(1);
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_FIRST_PIN, 	GET_VAR_BIT(character,0));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_SECOND_PIN, 	GET_VAR_BIT(character,1));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_THIRD_PIN, 	GET_VAR_BIT(character,2));
-	GPIO_writePin(LCD_Command_Data_PORT, LCD_Command_Data_FOURTH_PIN,   GET_VAR_BIT(character,3));
-	_delay_ms(1);
-	GPIO_writePin(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
-	_delay_ms(1);
-#endif
-}
+/*Displaying a magnitude with its sign, decimal point, width and padding*/
+static void LCD_putNumber(uint32 magnitude, uint8 negative, uint8 fracDigits, uint8 width, LCD_PadType pad);
 
 /*Sending a specific string*/
-void LCD_SendString(uint8 *strPtr)
+void LCD_SendString(const char *strPtr)
 {
 	/*Looping on the string elements and sending them One By One*/
 	uint8 var = 0;
+	TRACE(TRACE_LCD_STRING, strPtr[0]);
 	while (strPtr[var] != '\0') {
 		LCD_SendCharacter(strPtr[var]);	/*Sending each character*/
 		var++;
 	}
+	TRACE(TRACE_LCD_DONE, var);
 }
 
 /*Setting the cursor (displaying at row & column) */
@@ -213,9 +123,104 @@ void LCD_SendStringAtRowColumn(uint8 row,uint8 col,const char *Str)
 /*display any number as string*/
 void LCD_intgerToString(uint8 data)
 {
-	uint8 ASCII_Str[16];			/*an array to hold that string*/
-	itoa(data, ASCII_Str, 10);		/*A function that turns each digit in a number into its ASCII*/
-	LCD_SendString(ASCII_Str);
+	LCD_putU16(data, 0, LCD_PAD_SPACE);
+}
+
+/*Display an unsigned 16-bit number*/
+void LCD_putU16(uint16 value, uint8 width, LCD_PadType pad)
+{
+	LCD_putNumber(value, FALSE, 0, width, pad);
+}
+
+/*Display an unsigned 32-bit number*/
+void LCD_putU32(uint32 value, uint8 width, LCD_PadType pad)
+{
+	LCD_putNumber(value, FALSE, 0, width, pad);
+}
+
+/*Display a signed 32-bit number*/
+void LCD_putS32(sint32 value, uint8 width, LCD_PadType pad)
+{
+	LCD_putFixed(value, 0, width, pad);
+}
+
+/*Display a scaled integer as a fixed point number*/
+void LCD_putFixed(sint32 value, uint8 fracDigits, uint8 width, LCD_PadType pad)
+{
+	if(fracDigits >= LCD_MAX_DIGITS)
+	{
+		fracDigits = LCD_MAX_DIGITS - 1;
+	}
+
+	if(value < 0)
+	{
+		/*negating in unsigned arithmetic so that the most negative value is handled too*/
+		LCD_putNumber((uint32)0 - (uint32)value, TRUE, fracDigits, width, pad);
+	}
+	else
+	{
+		LCD_putNumber((uint32)value, FALSE, fracDigits, width, pad);
+	}
+}
+
+/*
+ * Description :
+ * Send the digits of a number straight to the LCD, most significant first.
+ * 1. Count the digits (at least one, and at least one before the point for fixed point numbers).
+ * 2. Fill the leading positions up to the required width (sign before zeros, after spaces).
+ * 3. Extract every digit by subtracting its power of ten (max 9 subtractions per digit).
+ */
+static void LCD_putNumber(uint32 magnitude, uint8 negative, uint8 fracDigits, uint8 width, LCD_PadType pad)
+{
+	uint8 index, digits = 1, length;
+	uint8 digit;
+	uint32 power;
+
+	for(index = 0; index < (LCD_MAX_DIGITS - 1); index++)
+	{
+		if(magnitude >= pgm_read_dword(&LCD_powersOfTen[index]))
+		{
+			digits = LCD_MAX_DIGITS - index;
+			break;
+		}
+	}
+	if((fracDigits > 0) && (digits <= fracDigits))
+	{
+		digits = fracDigits + 1;	/*"0.05" instead of ".05"*/
+	}
+
+	length = digits + negative + ((fracDigits > 0) ? 1 : 0);
+
+	/*the sign goes before a zero padding but after a space padding*/
+	if(negative && (pad == LCD_PAD_ZERO))
+	{
+		LCD_SendCharacter('-');
+	}
+	for(; width > length; width--)
+	{
+		LCD_SendCharacter((pad == LCD_PAD_ZERO) ? '0' : ' ');
+	}
+	if(negative && (pad == LCD_PAD_SPACE))
+	{
+		LCD_SendCharacter('-');
+	}
+
+	for(index = LCD_MAX_DIGITS - digits; index < LCD_MAX_DIGITS; index++)
+	{
+		if((fracDigits > 0) && ((LCD_MAX_DIGITS - index) == fracDigits))
+		{
+			LCD_SendCharacter('.');
+		}
+
+		power = pgm_read_dword(&LCD_powersOfTen[index]);
+		digit = '0';
+		while(magnitude >= power)
+		{
+			magnitude -= power;
+			digit++;
+		}
+		LCD_SendCharacter(digit);
+	}
 }
 
 /*Display the required character in a specific row and column index on the screen*/
@@ -229,5 +234,6 @@ void LCD_SendCharacterAtRowColumn(uint8 row,uint8 col, uint8 character)
 /*Send the clear screen command*/
 void LCD_ClearScreen(void)
 {
+	TRACE(TRACE_LCD_CLEAR, 0);
 	LCD_SendCommand(LCD_CLEAR_COMMAND);
 }
@@ -39,6 +39,19 @@
 #define LCD_Second_Row_address						0x40
 #define LCD_Third_Row_address						0x10
 #define LCD_Fourth_Row_address						0x50
+#define LCD_POWER_ON_DELAY_MS						15			/*From power-on to the first command*/
+
+/*Number formatting config.*/
+#define LCD_MAX_DIGITS								10			/*uint32 needs at most 10 decimal digits*/
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+/*Filling used for the unused leading positions of a fixed-width number*/
+typedef enum
+{
+	LCD_PAD_SPACE,	/*"  42"*/
+	LCD_PAD_ZERO	/*"0042"*/
+}LCD_PadType;
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
@@ -46,6 +59,9 @@
 /*LCD initialization*/
 void LCD_init(void);
 
+/*LCD initialization when LCD_POWER_ON_DELAY_MS already passed since power-on (no power-on delay)*/
+void LCD_initAfterPowerOn(void);
+
 /*LCD Commands display*/
 void LCD_SendCommand(uint8 command);
 
@@ -56,7 +72,7 @@ void LCD_SendCharacter(uint8 character);
 void LCD_SendCharacterAtRowColumn(uint8 row,uint8 col, uint8 character);
 
 /*Displaying a normal Located string (Always displayed at row 0 and column 0)*/
-void LCD_SendString(uint8 *strPtr);
+void LCD_SendString(const char *strPtr);
 
 /*Setting the cursor to a specific location*/
 void LCD_MoveCursor(uint8 row, uint8 col);
@@ -67,6 +83,21 @@ void LCD_SendStringAtRowColumn(uint8 row,uint8 col,const char *Str);
 /*Converting an integer to string*/
 void LCD_intgerToString(uint8 data);
 
+/*
+ * Displaying unsigned/signed numbers directly on the screen (no itoa, no printf, no buffer).
+ * width: minimum number of characters to occupy (0 = as many as needed), the sign counts as one.
+ * pad  : what fills the unused leading positions (LCD_PAD_SPACE or LCD_PAD_ZERO).
+ */
+void LCD_putU16(uint16 value, uint8 width, LCD_PadType pad);
+void LCD_putU32(uint32 value, uint8 width, LCD_PadType pad);
+void LCD_putS32(sint32 value, uint8 width, LCD_PadType pad);
+
+/*
+ * Displaying a fixed point number, value is scaled by 10^fracDigits
+ * e.g. LCD_putFixed(-1234, 2, 0, LCD_PAD_SPACE) displays "-12.34"
+ */
+void LCD_putFixed(sint32 value, uint8 fracDigits, uint8 width, LCD_PadType pad);
+
 /*Removing what is displayed on the screen*/
 void LCD_ClearScreen(void);
 
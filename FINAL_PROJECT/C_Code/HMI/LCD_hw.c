@@ -0,0 +1,138 @@
+/*
+ * LCD_hw.c
+ *
+ *  Created on: Sep 27, 2024
+ *      Author: amr mohamed
+ */
+
+/*
+ * LCD bus level functions (AVR backend): the pin sequences and timings of the HD44780.
+ * The rest of the driver (LCD.c) only uses LCD_init(), LCD_SendCommand() and LCD_SendCharacter(),
+ * so replacing this file (with LCD_initAfterPowerOn()) is enough to run the driver on another target.
+ */
+
+
+#include "LCD.h"
+#include"gpio.h"
+#include"std_types.h"
+#include <util/delay.h>
+#include "common_macros.h"
+
+/*LCD initialization*/
+void LCD_init(void)
+{
+	/* LCD Power ON delay (always > 15ms) */
+	_delay_ms(LCD_POWER_ON_DELAY_MS);
+	LCD_initAfterPowerOn();
+}
+
+/*LCD initialization, the power on delay is already over*/
+void LCD_initAfterPowerOn(void)
+{
+	/*Setting the direction of the main pins as OUTPUT*/
+	GPIO_SETUP_PIN_DIRECTION(LCD_RS_PORT, LCD_RS_PIN, 		PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(LCD_Enable_PORT, LCD_Enable_PIN, PIN_OUTPUT);
+
+#if(LDC_MODE == 8)
+	GPIO_SETUP_PORT_DIRECTION(LCD_Command_Data_PORT, PORT_OUTPUT);
+#else
+
+	GPIO_SETUP_PIN_DIRECTION(LCD_Command_Data_PORT, LCD_Command_Data_FIRST_PIN, 	PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(LCD_Command_Data_PORT, LCD_Command_Data_SECOND_PIN, 	PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(LCD_Command_Data_PORT, LCD_Command_Data_THIRD_PIN, 	PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(LCD_Command_Data_PORT, LCD_Command_Data_FOURTH_PIN,  PIN_OUTPUT);
+#endif
+
+
+	/*Setting LCD modes & initial Setup*/
+#if(LDC_MODE == 8)
+	LCD_SendCommand(LCD_TWO_LINES_EIGHT_BITS_MODE);
+#else
+	/* Send for 4 bit initialization of LCD  */
+	LCD_SendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
+	LCD_SendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2);
+	LCD_SendCommand(LCD_TWO_LINES_FOUR_BITS_MODE);
+#endif
+	LCD_SendCommand(LCD_CURSOR_OFF);
+	LCD_SendCommand(LCD_CLEAR_COMMAND);
+}
+
+/*Sending required commands*/
+void LCD_SendCommand(uint8 command)
+{
+#if(LDC_MODE == 8)
+	/*following this scenario from the Data Sheet Timing Diagram*/
+	GPIO_WRITE_PIN(LCD_RS_PORT, LCD_RS_PIN, LOGIC_LOW);
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
+	_delay_ms(1);
+	GPIO_WRITE_PORT(LCD_Command_Data_PORT, command);
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
+	_delay_ms(1);
+#else
+	GPIO_WRITE_PIN(LCD_RS_PORT, LCD_RS_PIN, LOGIC_LOW);
+
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_FIRST_PIN, 	GET_VAR_BIT(command,4));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_SECOND_PIN, 	GET_VAR_BIT(command,5));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_THIRD_PIN, 	GET_VAR_BIT(command,6));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_FOURTH_PIN,   GET_VAR_BIT(command,7));
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
+	_delay_ms(1);
+
+
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_FIRST_PIN, 	GET_VAR_BIT(command,0));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_SECOND_PIN, 	GET_VAR_BIT(command,1));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_THIRD_PIN, 	GET_VAR_BIT(command,2));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_FOURTH_PIN,   GET_VAR_BIT(command,3));
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
+	_delay_ms(1);
+#endif
+}
+
+/*Sending a specific character*/
+void LCD_SendCharacter(uint8 character)
+{
+#if(LDC_MODE == 8)
+	/*following this scenario from the Data Sheet Timing Diagram*/
+	GPIO_WRITE_PIN(LCD_RS_PORT, LCD_RS_PIN, LOGIC_HIGH);
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
+	_delay_ms(1);
+	GPIO_WRITE_PORT(LCD_Command_Data_PORT, character);
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
+	_delay_ms(1);
+#else
+	GPIO_WRITE_PIN(LCD_RS_PORT, LCD_RS_PIN, LOGIC_HIGH);
+
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_FIRST_PIN, 	GET_VAR_BIT(character,4));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_SECOND_PIN, 	GET_VAR_BIT(character,5));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_THIRD_PIN, 	GET_VAR_BIT(character,6));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_FOURTH_PIN,   GET_VAR_BIT(character,7));
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
+	_delay_ms(1);
+
+
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_HIGH);
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_FIRST_PIN, 	GET_VAR_BIT(character,0));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_SECOND_PIN, 	GET_VAR_BIT(character,1));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_THIRD_PIN, 	GET_VAR_BIT(character,2));
+	GPIO_WRITE_PIN(LCD_Command_Data_PORT, LCD_Command_Data_FOURTH_PIN,   GET_VAR_BIT(character,3));
+	_delay_ms(1);
+	GPIO_WRITE_PIN(LCD_Enable_PORT, LCD_Enable_PIN, LOGIC_LOW);
+	_delay_ms(1);
+#endif
+}
@@ -6,12 +6,18 @@
  */
 
 #include <avr/io.h>
+#include "boot_profile.h"
 #include "common_macros.h"
+#include "cpu_load.h"
 #include "gpio.h"
 #include "keypad.h"
+#include "latency.h"
 #include "LCD.h"
+#include "stack_monitor.h"
 #include "std_types.h"
 #include "Timer.h"
+#include "timestamp.h"
+#include "trace.h"
 #include "UART.h"
 #include <util/delay.h>
 #include <stdlib.h>
@@ -41,20 +47,80 @@ void phaseTwo(void);    /* Password verification and error tracking*/
 void phaseThree(void);  /* Options to open door or change password*/
 void phaseFour(void);   /* Door operation status display*/
 void phaseFive(void);   /* System lock display after multiple failed attempts*/
+uint8 receiveControlByte(void);  /* Next byte of the Main Controller, its service frames dropped */
+
+/*
+ * Timer1 overflow (every 8.4s), one more period for the trace and for the time base of the latency,
+ * CPU load and boot measurements, and the next part of the stack scan
+ */
+void stampTimerCallBack(void)
+{
+    Trace_period();
+    Timestamp_period();
+    StackMonitor_check();
+}
+
+/*
+ * UART events: the trace records of the link and the idle time of the waits for a byte
+ */
+void uartCallBack(UART_EventType event, uint8 data)
+{
+    switch(event)
+    {
+    case UART_EVENT_TX:
+        TRACE(TRACE_UART_TX, data);
+        break;
+    case UART_EVENT_RX_WAIT:
+        TRACE(TRACE_UART_RX_WAIT, 0);
+        CpuLoad_idleBegin();
+        break;
+    case UART_EVENT_RX:
+        CpuLoad_idleEnd();
+        TRACE(TRACE_UART_RX, data);
+        break;
+    }
+    (void)data;  // Not used when the trace is built out
+}
+
 int main(void)
 {
     // UART configuration: Baud rate 9600, No parity, 8 data bits, 1 stop bit
     UART_Config UARTRuntime = {9600, DISABLED, EIGHT_BITS, ONE_BIT};
 
-    // Initialize the LCD display
-    LCD_init();
+    // Timer1 free running at F_CPU/1024, the timestamps of the trace, latency, CPU load and boot measurements
+    Timer_ConfigType StampTimer = {0, 0, Timer_1, Fcpu_1024, NORMAL_MODE};
+
+    // Empty trace buffer, latency histograms and CPU load, their timestamps come from Timer1
+    Trace_init();
+    Latency_init();
+    CpuLoad_init();
+    StackMonitor_init();  // Stack high-water mark, the stack was painted before main()
+    Timer_setCallBack(stampTimerCallBack, Timer_1);
+    Timer_init(&StampTimer);
 
     // Initialize UART communication with specified settings
     UART_Init(&UARTRuntime);
+    UART_setCallBack(uartCallBack);
+    BootProfile_mark(BOOT_UART);
+
+    // Initialize the keypad, it is scanned in the background from the timer interrupt
+    KEYPAD_init();
+    SREG |= (1<<7);  // Enable Global Interrupt (I-Bit) for the keypad scan
+    BootProfile_mark(BOOT_KEYPAD);  // Keys typed while the LCD starts are queued
+
+    // The LCD power-on delay runs from the reset, the inits above already took part of it
+    CpuLoad_idleBegin();
+    BootProfile_waitSinceStart(BOOT_MS_TO_COUNTS(LCD_POWER_ON_DELAY_MS));
+    CpuLoad_idleEnd();
+    LCD_initAfterPowerOn();
+    BootProfile_mark(BOOT_LCD);
 
     // Main control loop
     while(1)
     {
+        // The CPU time from here on belongs to this phase
+        CpuLoad_setPhase(PhasesSwitch);
+
         // If in phase 1 or reset phase (6), handle initialization or reset logic
         if(PhasesSwitch == 1 || PhasesSwitch == 6)
         {
@@ -96,6 +162,8 @@ void phaseOne(void) {
     uint8 var;  /* Variables for temporary storage of key input and verification */
     static uint8 passDigit, initialPassLimit; /* Variables to store the pressed key and count of entered characters */
 
+    TRACE(TRACE_PHASE, 1);
+
     /* Clear the LCD display */
     LCD_ClearScreen();
 
@@ -104,12 +172,17 @@ void phaseOne(void) {
 
     /* Display the message prompting the user to enter the password */
     LCD_SendString("PLZ enter pass:");
+    BootProfile_mark(BOOT_READY);  /* Only the first prompt after the reset counts */
 
-    /* Loop until the '=' key is pressed or 5 characters have been entered */
-    while (KEYPAD_getPressedKey() != '=' || initialPassLimit < 5) {
-        /* Get the key pressed from the keypad */
+    /* Loop until the '=' key is pressed after 5 characters have been entered */
+    while (1) {
+        /* Get the next key pressed from the keypad queue (keys typed ahead are not lost) */
     	passDigit = KEYPAD_getPressedKey();
 
+        if (passDigit == '=' && initialPassLimit == 5) {
+            break;
+        }
+
         /* Check if the key is a valid number (0-9) and ensure less than 5 characters have been entered */
         if ((passDigit <= 9) && (passDigit >= 0) && initialPassLimit < 5) {
             /* Move the cursor to the corresponding position in the second row */
@@ -117,50 +190,50 @@ void phaseOne(void) {
 
             /* Display a '*' character for each entered digit (masks the actual input) */
             LCD_SendCharacter('*');
+            Latency_stop(LATENCY_KEY_ECHO);  /* The key press is shown */
 
             /* Store the pressed key in the password array */
             passSetArr[initialPassLimit] = passDigit;
 
             /* Increment the count to move to the next position on the display */
             initialPassLimit++;
-
-            /* Small delay to allow time for the key press and avoid multiple detections */
-            _delay_ms(250);
         }
     }
 
-    /* Check if the '=' key was pressed and exactly 5 characters have been entered */
-    if (KEYPAD_getPressedKey() == '=' && initialPassLimit == 5) {
-        /* If in phase 6, send the password for verification */
-        if (PhasesSwitch == 6) {
-            UART_sendByte('F');  /* Indicate that password entry has started */
-            for (var = 0; var < 5; ++var) {
-                UART_sendByte(passSetArr[var]);  /* Send each digit of the password */
-                _delay_ms(10);  /* Short delay between sends */
-            }
+    /* The '=' key was pressed and exactly 5 characters have been entered */
+    /* If in phase 6, send the password for verification */
+    if (PhasesSwitch == 6) {
+        Latency_startFrom(LATENCY_AUTH_VERDICT, LATENCY_KEY_ECHO);  /* From the '=' press */
+        UART_sendByte('F');  /* Indicate that password entry has started */
+        for (var = 0; var < 5; ++var) {
+            UART_sendByte(passSetArr[var]);  /* Send each digit of the password */
+            _delay_ms(10);  /* Short delay between sends */
+        }
 
-            /* Wait for a response from the HMI */
-            while (1) {
-                uint8 temp = UART_recieveByte();  /* Receive a byte from UART */
-                if (temp == 'Z') {
-                    break;  /* Exit the loop on valid response */
-                } else if (temp == 'X') {
-                    LCD_ClearScreen();  /* Clear the display on mismatch */
-                    initialPassLimit = 0;  /* Reset password limit */
-                    PhasesSwitch = 4;   /* Transition to phase 4 */
-                    break;  /* Exit the loop */
-                } else if (temp == Alarm_BYTE) {
-                    /* Handle alarm condition */
-                	initialPassLimit = 0;  /* Reset password limit */
-                    PhasesSwitch = 5;   /* Transition to alarm phase */
-                    break;  /* Exit the loop */
-                }
+        /* Wait for a response from the HMI */
+        while (1) {
+            uint8 temp = receiveControlByte();  /* Receive a byte from UART */
+            if (temp == 'Z') {
+                Latency_stop(LATENCY_AUTH_VERDICT);
+                break;  /* Exit the loop on valid response */
+            } else if (temp == 'X') {
+                Latency_stop(LATENCY_AUTH_VERDICT);
+                LCD_ClearScreen();  /* Clear the display on mismatch */
+                initialPassLimit = 0;  /* Reset password limit */
+                PhasesSwitch = 4;   /* Transition to phase 4 */
+                break;  /* Exit the loop */
+            } else if (temp == Alarm_BYTE) {
+                Latency_stop(LATENCY_AUTH_VERDICT);
+                /* Handle alarm condition */
+            	initialPassLimit = 0;  /* Reset password limit */
+                PhasesSwitch = 5;   /* Transition to alarm phase */
+                break;  /* Exit the loop */
             }
-            initialPassLimit = 0;  /* Reset password limit after processing */
-        } else {
-        	initialPassLimit = 0;  /* Reset password limit */
-            PhasesSwitch = 2;    /* Transition to phase 2 */
         }
+        initialPassLimit = 0;  /* Reset password limit after processing */
+    } else {
+    	initialPassLimit = 0;  /* Reset password limit */
+        PhasesSwitch = 2;    /* Transition to phase 2 */
     }
 }
 
@@ -172,6 +245,8 @@ void phaseTwo(void) {
     uint8 var, wrongPass = 0, passLimit = 0;  /* Variables for tracking the number of entered characters and error state */
     static uint8 passDigit;  /* Variable to store the pressed key */
 
+    TRACE(TRACE_PHASE, 2);
+
     /* Clear the LCD display */
     LCD_ClearScreen();
 
@@ -181,11 +256,15 @@ void phaseTwo(void) {
     /* Display the message prompting the user to re-enter the password */
     LCD_SendString("Re_enter pass:  ");
 
-    /* Loop until the '=' key is pressed or 5 characters have been entered */
-    while (KEYPAD_getPressedKey() != '=' || passLimit < 5) {
-        /* Get the key pressed from the keypad */
+    /* Loop until the '=' key is pressed after 5 characters have been entered */
+    while (1) {
+        /* Get the next key pressed from the keypad queue (keys typed ahead are not lost) */
     	passDigit = KEYPAD_getPressedKey();
 
+        if (passDigit == '=' && passLimit == 5) {
+            break;
+        }
+
         /* Check if the key is a valid number (0-9) and ensure less than 5 characters have been entered */
         if ((passDigit <= 9) && (passDigit >= 0) && passLimit < 5) {
             /* Move the cursor to the corresponding position in the second row */
@@ -193,40 +272,36 @@ void phaseTwo(void) {
 
             /* Display a '*' character for each entered digit (masks the actual input) */
             LCD_SendCharacter('*');
+            Latency_stop(LATENCY_KEY_ECHO);  /* The key press is shown */
 
             /* Store the pressed key in the comparison array */
             passCompareArr[passLimit] = passDigit;
 
             /* Increment the count to move to the next position on the display */
             passLimit++;
-
-            /* Small delay to allow time for the key press and avoid multiple detections */
-            _delay_ms(250);
         }
     }
 
-    /* Check if the '=' key was pressed and exactly 5 characters have been entered */
-    if (KEYPAD_getPressedKey() == '=' && passLimit == 5) {
-        /* Compare the entered password with the stored password */
-        for (var = 0; var < 5; ++var) {
-            if (passSetArr[var] != passCompareArr[var]) {
-                passLimit = 0;  /* Reset password limit on mismatch */
-                wrongPass = 1;  /* Set flag indicating the passwords do not match */
-            }
+    /* The '=' key was pressed and exactly 5 characters have been entered */
+    /* Compare the entered password with the stored password */
+    for (var = 0; var < 5; ++var) {
+        if (passSetArr[var] != passCompareArr[var]) {
+            passLimit = 0;  /* Reset password limit on mismatch */
+            wrongPass = 1;  /* Set flag indicating the passwords do not match */
         }
+    }
 
-        /* If a mismatch occurred, transition back to phase 1 */
-        if (wrongPass == 1) {
-            PhasesSwitch = 1;  /* Transition to phase 1 for re-entry */
-        } else {
-            /* If passwords match, send confirmation to the HMI */
-            UART_sendByte('S');  /* Indicate successful password entry */
-            for (var = 0; var < 5; ++var) {
-                UART_sendByte(passSetArr[var]);  /* Send the stored password for verification */
-                _delay_ms(10);  /* Short delay between sends */
-            }
-            PhasesSwitch = 3;  /* Transition to phase 3 */
+    /* If a mismatch occurred, transition back to phase 1 */
+    if (wrongPass == 1) {
+        PhasesSwitch = 1;  /* Transition to phase 1 for re-entry */
+    } else {
+        /* If passwords match, send confirmation to the HMI */
+        UART_sendByte('S');  /* Indicate successful password entry */
+        for (var = 0; var < 5; ++var) {
+            UART_sendByte(passSetArr[var]);  /* Send the stored password for verification */
+            _delay_ms(10);  /* Short delay between sends */
         }
+        PhasesSwitch = 3;  /* Transition to phase 3 */
     }
 }
 
@@ -241,26 +316,57 @@ void phaseTwo(void) {
  * sends the '+' command over UART to the Main Controller to start the door-opening process.
  * If the '-' key is pressed, it clears the screen, transitions to phase 1,
  * and sends the '-' command over UART to initiate the password change process.
+ * Service keys (not shown), only when held for a long press (~1s, KEYPAD_LONG_PRESS_TICKS),
+ * a short press of them does nothing:
+ * the '*' key sends the trace buffer and the boot profile on the link (see trace.h and boot_profile.h),
+ * the '%' key sends the latency histograms and clears them (see latency.h),
+ * the Enter key sends the CPU load (see cpu_load.h),
+ * the '=' key sends the RAM use and the stack high-water mark (see stack_monitor.h).
  */
 void phaseThree(void)
 {
+    uint8 key;
+
+    TRACE(TRACE_PHASE, 3);
     LCD_MoveCursor(0, 0);
     LCD_SendString("+ : Open Door   ");
     LCD_MoveCursor(1, 0);
     LCD_SendString("- : Change Pass ");
 
-    if (KEYPAD_getPressedKey() == '+')
+    key = KEYPAD_getPressedKey();
+    if (key == '+')
     {
         LCD_ClearScreen();
         PhasesSwitch = 6;    // Switch to door opening phase
         UART_sendByte('+');  // Notify Main Controller to open the door
     }
-    else if (KEYPAD_getPressedKey() == '-')
+    else if (key == '-')
     {
         LCD_ClearScreen();
         PhasesSwitch = 1;    // Switch to password change phase
         UART_sendByte('-');  // Notify Main Controller to start password change
     }
+    else if ((key == '*' || key == '%' || key == 13 || key == '=') && KEYPAD_isLongPress(key))
+    {
+        if (key == '*')
+        {
+            Trace_dump();        // Service: send the trace buffer on the link (the Main Controller skips it)
+            BootProfile_dump();  // and the boot profile
+        }
+        else if (key == '%')
+        {
+            Latency_dump();      // Service: send the latency histograms on the link (the Main Controller skips them)
+            Latency_reset();     // and start a new measurement
+        }
+        else if (key == 13)
+        {
+            CpuLoad_dump();      // Service: send the CPU load on the link (the Main Controller skips it)
+        }
+        else
+        {
+            StackMonitor_dump(); // Service: send the RAM use on the link (the Main Controller skips it)
+        }
+    }
 }
 
 /*
@@ -279,7 +385,8 @@ void phaseThree(void)
 void phaseFour(void)
 {
     static UARTDoorState doorState;
-    doorState = UART_recieveByte();  // Receive door state byte from Main Controller
+    TRACE(TRACE_PHASE, 4);
+    doorState = receiveControlByte();  // Receive door state byte from Main Controller
 
     switch (doorState)
     {
@@ -323,16 +430,54 @@ void phaseFour(void)
 void phaseFive(void)
 {
 	static UARTDoorState alarmState;
+    TRACE(TRACE_PHASE, 5);
     LCD_MoveCursor(0, 0);
     LCD_SendString("SYSTEM LOCKED   ");
     LCD_MoveCursor(1, 0);
     LCD_SendString("Wait for 1 min  ");
 
-    TOGGLE_BIT(PORTA, 0);  // Toggle indicator for system locked state
-    alarmState = UART_recieveByte();  // Receive state from Main Controller
+    GPIO_TOGGLE_PINS_ATOMIC(PORTA_ID, (1 << PIN0_ID));  // Toggle indicator for system locked state
+    alarmState = receiveControlByte();  // Receive state from Main Controller
 
     if (alarmState == OPEN_BYTE)
     {
         PhasesSwitch = 3;  // Return to main options upon unlock
     }
 }
+
+/*
+ * Function: receiveControlByte
+ * ----------------------------
+ * Receives the next byte of the Main Controller. A service frame it sends when a service
+ * request reaches it on the link (trace, latency, CPU load, RAM or boot dump) is read and
+ * dropped, so its bytes are never taken for a door or password state.
+ */
+uint8 receiveControlByte(void)
+{
+    uint8 data;
+
+    while (1)
+    {
+        data = UART_recieveByte();
+        switch (data)
+        {
+        case TRACE_FRAME_START:
+            Trace_skipFrame();
+            break;
+        case LATENCY_FRAME_START:
+            Latency_skipFrame();
+            break;
+        case CPULOAD_FRAME_START:
+            CpuLoad_skipFrame();
+            break;
+        case STACKMON_FRAME_START:
+            StackMonitor_skipFrame();
+            break;
+        case BOOT_FRAME_START:
+            BootProfile_skipFrame();
+            break;
+        default:
+            return data;
+        }
+    }
+}
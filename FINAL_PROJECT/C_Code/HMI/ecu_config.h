@@ -0,0 +1,27 @@
+/*
+ * ecu_config.h
+ *
+ *  Compile-time configuration of the HMI ECU for the shared modules of ../Common
+ *  (trace, timestamp, latency, cpu_load, stack_monitor, boot_profile), built with this directory in the include path.
+ */
+
+#ifndef ECU_CONFIG_H_
+#define ECU_CONFIG_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define ECU_ID                         'H'      /* ECU id in the dump frames */
+
+/* Timer1 runs free (normal mode, stampTimerCallBack), the time base of the measurements */
+#define ECU_TIMESTAMP_TOP              0xFFFF   /* TCNT1 counts 0..TOP */
+#define ECU_TIMESTAMP_PERIOD_FLAG      TOV1     /* TIFR flag raised at the end of a period */
+
+#define ECU_STACKMON_SCAN_STEP         255      /* Paint bytes scanned per Timer1 period (8.4s) */
+
+#define ECU_PHASES                     7        /* PhasesSwitch 0..6 */
+
+#define ECU_LATENCY_FIRST              LATENCY_KEY_ECHO      /* Histograms measured here (see latency.h) */
+#define ECU_LATENCY_LAST               LATENCY_AUTH_VERDICT
+
+#endif /* ECU_CONFIG_H_ */
@@ -11,144 +11,349 @@
  *******************************************************************************/
 #include "keypad.h"
 #include "gpio.h"
-#include <util/delay.h>
+#include "common_macros.h"
+#include "cpu_load.h"
+#include "latency.h"
+#include "trace.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <avr/sleep.h>
 
 /*******************************************************************************
  *                      Functions Prototypes(Private)                          *
  *******************************************************************************/
 
-#if (KEYPAD_NUM_COLS == 3)
 /*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x3 keypad
+ * Function responsible for one pass over all the rows,
+ * returns a mask with bit ((row*KEYPAD_NUM_COLS)+col) set for every pressed switch
  */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number);
-#elif (KEYPAD_NUM_COLS == 4)
+static uint16 KEYPAD_scanMatrix(void);
+
 /*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x4 keypad
+ * Function responsible for mapping a switch index in the matrix to its key value
  */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
+static uint8 KEYPAD_keyOf(uint8 index);
+
+/*******************************************************************************
+ *                      Private Constants                                      *
+ *******************************************************************************/
+
+/* Mask of the column bits once shifted down to bit 0 */
+#define KEYPAD_COLS_MASK                 ((1 << KEYPAD_NUM_COLS) - 1)
+
+/* Row and column bits in their ports */
+#define KEYPAD_ROWS_BITS                 (((1 << KEYPAD_NUM_ROWS) - 1) << KEYPAD_FIRST_ROW_PIN_ID)
+#define KEYPAD_COLS_BITS                 (KEYPAD_COLS_MASK << KEYPAD_FIRST_COL_PIN_ID)
+
+/* Key value of every switch, generated from the keymap description in keypad.h */
+static const uint8 g_keymap[KEYPAD_NUM_ROWS][KEYPAD_NUM_COLS] PROGMEM = KEYPAD_KEYMAP;
+
+/* Periodic scan tick */
+static const Timer_ConfigType g_scanTimer = {0, KEYPAD_TIMER_COMPARE_VALUE, KEYPAD_TIMER_ID, KEYPAD_TIMER_CLOCK, COMPARE_MODE};
+
+#if (KEYPAD_WAKE_ENABLE == TRUE)
+/*
+ * Function responsible for stopping the scan and arming the wake-up interrupt
+ */
+static void KEYPAD_enterIdle(void);
 #endif
 
+/*
+ * Function responsible for adding an event to the queue (called from the scan tick only)
+ */
+static void KEYPAD_pushEvent(uint8 key, KEYPAD_EventType type);
+
+/*******************************************************************************
+ *                      Private Variables                                      *
+ *******************************************************************************/
+
+/*
+ * Single producer (scan tick) / single consumer (application) ring buffer.
+ * The head is only written by the producer and the tail only by the consumer,
+ * both are one byte wide so their updates are atomic and no locking is needed.
+ */
+static volatile KEYPAD_Event g_eventQueue[KEYPAD_EVENT_QUEUE_SIZE];
+static volatile uint8 g_eventHead = 0;
+static volatile uint8 g_eventTail = 0;
+
+static uint8 g_integrator[KEYPAD_NUM_ROWS*KEYPAD_NUM_COLS];  /* Debounce integrator per switch */
+static uint16 g_debouncedState = 0;          /* Bit set for every switch reported as pressed */
+static uint8 g_holdIndex = KEYPAD_NO_KEY;    /* Switch index of the last pressed key */
+static uint8 g_holdTicks = 0;                /* Ticks since that key was pressed */
+static uint8 g_quietTicks = 0;               /* Consecutive ticks with every switch released */
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
 
-uint8 KEYPAD_getPressedKey(void)
+void KEYPAD_init(void)
 {
-	uint8 col,row;
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+3, PIN_INPUT);
-
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+2, PIN_INPUT);
-#if(KEYPAD_NUM_COLS == 4)
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+3, PIN_INPUT);
+	uint8 index;
+
+	/*
+	 * The rows are inputs and their output latch holds the pressed level,
+	 * so strobing a row later is only a direction change.
+	 */
+	GPIO_DDR_REG(KEYPAD_ROW_PORT_ID) &= ~KEYPAD_ROWS_BITS;
+#if (KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+	GPIO_PORT_REG(KEYPAD_ROW_PORT_ID) &= ~KEYPAD_ROWS_BITS;
+#else
+	GPIO_PORT_REG(KEYPAD_ROW_PORT_ID) |= KEYPAD_ROWS_BITS;
 #endif
-	while(1)
+
+	GPIO_DDR_REG(KEYPAD_COL_PORT_ID) &= ~KEYPAD_COLS_BITS;
+
+	for(index=0 ; index<(KEYPAD_NUM_ROWS*KEYPAD_NUM_COLS) ; index++)
 	{
-		for(row=0 ; row<KEYPAD_NUM_ROWS ; row++) /* loop for rows */
-		{
-			/* 
-			 * Each time setup the direction for all keypad port as input pins,
-			 * except this row will be output pin
-			 */
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_OUTPUT);
+		g_integrator[index] = 0;
+	}
+	g_debouncedState = 0;
+	g_holdIndex = KEYPAD_NO_KEY;
+	g_holdTicks = 0;
+	g_quietTicks = 0;
+	g_eventHead = 0;
+	g_eventTail = 0;
+
+#if (KEYPAD_WAKE_ENABLE == TRUE)
+	/* Wake-up line input with pull-up, INT0 on falling edge (armed only while idle) */
+	GPIO_SETUP_PIN_DIRECTION(KEYPAD_WAKE_PORT_ID, KEYPAD_WAKE_PIN_ID, PIN_INPUT);
+	GPIO_WRITE_PIN(KEYPAD_WAKE_PORT_ID, KEYPAD_WAKE_PIN_ID, LOGIC_HIGH);
+	MCUCR = (MCUCR & ~((1 << ISC01) | (1 << ISC00))) | (1 << ISC01);
+	CLEAR_BIT(GICR, INT0);
+#endif
 
-			/* Set/Clear the row output pin */
-			GPIO_writePin(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+row, KEYPAD_BUTTON_PRESSED);
+	set_sleep_mode(SLEEP_MODE_IDLE);
 
-			for(col=0 ; col<KEYPAD_NUM_COLS ; col++) /* loop for columns */
+	Timer_setCallBack(KEYPAD_scanTick, KEYPAD_TIMER_ID);
+	Timer_init(&g_scanTimer);
+}
+
+#if (KEYPAD_WAKE_ENABLE == TRUE)
+/*
+ * A key was touched while idle, release the rows and restart the scan
+ */
+ISR(INT0_vect)
+{
+	TRACE(TRACE_KEY_WAKE, 0);
+	CLEAR_BIT(GICR, INT0);
+	GPIO_DDR_REG(KEYPAD_ROW_PORT_ID) &= ~KEYPAD_ROWS_BITS;
+	g_quietTicks = 0;
+	Timer_init(&g_scanTimer);
+}
+#endif
+
+void KEYPAD_scanTick(void)
+{
+	uint16 sample = KEYPAD_scanMatrix();
+	uint16 mask = 1;
+	uint8 index;
+
+	for(index=0 ; index<(KEYPAD_NUM_ROWS*KEYPAD_NUM_COLS) ; index++, mask <<= 1)
+	{
+		/* Integrate the raw sample */
+		if(sample & mask)
+		{
+			if(g_integrator[index] < KEYPAD_DEBOUNCE_MAX)
 			{
-				/* Check if the switch is pressed in this column */
-				if(GPIO_readPin(KEYPAD_COL_PORT_ID,KEYPAD_FIRST_COL_PIN_ID+col) == KEYPAD_BUTTON_PRESSED)
-				{
-					#if (KEYPAD_NUM_COLS == 3)
-						return KEYPAD_4x3_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-					#elif (KEYPAD_NUM_COLS == 4)
-						return KEYPAD_4x4_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-					#endif
-				}
+				g_integrator[index]++;
 			}
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
-			_delay_ms(10); /* Add small delay to fix CPU load issue in proteus */
 		}
-	}	
+		else if(g_integrator[index] > 0)
+		{
+			g_integrator[index]--;
+		}
+
+		/* Report a change only when the integrator crosses the threshold of the opposite state */
+		if(!(g_debouncedState & mask) && (g_integrator[index] >= KEYPAD_PRESS_THRESHOLD))
+		{
+			g_debouncedState |= mask;
+			g_holdIndex = index;
+			g_holdTicks = 0;
+			KEYPAD_pushEvent(KEYPAD_keyOf(index), KEYPAD_PRESS);
+		}
+		else if((g_debouncedState & mask) && (g_integrator[index] <= KEYPAD_RELEASE_THRESHOLD))
+		{
+			g_debouncedState &= ~mask;
+			if(g_holdIndex == index)
+			{
+				g_holdIndex = KEYPAD_NO_KEY;
+			}
+			KEYPAD_pushEvent(KEYPAD_keyOf(index), KEYPAD_RELEASE);
+		}
+	}
+
+#if (KEYPAD_WAKE_ENABLE == TRUE)
+	/* Nothing pressed and nothing settling for a while, stop scanning until a key is touched */
+	if(sample == 0 && g_debouncedState == 0)
+	{
+		g_quietTicks++;
+		if(g_quietTicks >= KEYPAD_IDLE_TICKS)
+		{
+			KEYPAD_enterIdle();
+			return;
+		}
+	}
+	else
+	{
+		g_quietTicks = 0;
+	}
+#endif
+
+	/* Last pressed key still held, check for a long press */
+	if((g_holdIndex != KEYPAD_NO_KEY) && (g_holdTicks < KEYPAD_LONG_PRESS_TICKS))
+	{
+		g_holdTicks++;
+		if(g_holdTicks == KEYPAD_LONG_PRESS_TICKS)
+		{
+			KEYPAD_pushEvent(KEYPAD_keyOf(g_holdIndex), KEYPAD_LONG_PRESS);
+		}
+	}
 }
 
-#if (KEYPAD_NUM_COLS == 3)
-/*
- * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x3 shape
- */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number)
+uint8 KEYPAD_getEvent(KEYPAD_Event *event)
 {
-	uint8 keypad_button = 0;
-	switch(button_number)
+	uint8 tail = g_eventTail;
+
+	if(tail == g_eventHead)
 	{
-		case 10: keypad_button = '*'; // ASCII Code of *
-				 break;
-		case 11: keypad_button = 0;
-				 break;
-		case 12: keypad_button = '#'; // ASCII Code of #
-				 break;
-		default: keypad_button = button_number;
-				break;
+		return FALSE;
 	}
-	return keypad_button;
-} 
 
-#elif (KEYPAD_NUM_COLS == 4)
+	event->key = g_eventQueue[tail].key;
+	event->type = g_eventQueue[tail].type;
+
+	/* Free the slot only after it has been copied */
+	g_eventTail = (tail + 1) & (KEYPAD_EVENT_QUEUE_SIZE - 1);
+	return TRUE;
+}
 
 /*
- * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x4 shape
+ * Take the oldest key event from the queue, the CPU sleeps until there is one
  */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number)
+static void KEYPAD_waitEvent(KEYPAD_Event *event)
 {
-	uint8 keypad_button = 0;
-	switch(button_number)
+	while(!KEYPAD_getEvent(event))
 	{
-		case 1: keypad_button = 7;
-				break;
-		case 2: keypad_button = 8;
-				break;
-		case 3: keypad_button = 9;
-				break;
-		case 4: keypad_button = '%'; // ASCII Code of %
-				break;
-		case 5: keypad_button = 4;
-				break;
-		case 6: keypad_button = 5;
-				break;
-		case 7: keypad_button = 6;
-				break;
-		case 8: keypad_button = '*'; /* ASCII Code of '*' */
-				break;
-		case 9: keypad_button = 1;
-				break;
-		case 10: keypad_button = 2;
-				break;
-		case 11: keypad_button = 3;
-				break;
-		case 12: keypad_button = '-'; /* ASCII Code of '-' */
-				break;
-		case 13: keypad_button = 13;  /* ASCII of Enter */
-				break;
-		case 14: keypad_button = 0;
-				break;
-		case 15: keypad_button = '='; /* ASCII Code of '=' */
-				break;
-		case 16: keypad_button = '+'; /* ASCII Code of '+' */
-				break;
-		default: keypad_button = button_number;
-				break;
+		/*
+		 * Nothing queued, sleep until the next interrupt (scan tick, or the wake-up line while idle).
+		 * The queue is checked again with interrupts disabled and sei() is used right before
+		 * sleep_cpu() as the instruction after it always runs before a pending interrupt,
+		 * so an event pushed in between can't leave the CPU sleeping.
+		 */
+		CpuLoad_idleBegin();
+		cli();
+		if(g_eventTail == g_eventHead)
+		{
+			sleep_enable();
+			sei();
+			sleep_cpu();
+			sleep_disable();
+		}
+		sei();
+		CpuLoad_idleEnd();
 	}
-	return keypad_button;
-} 
+}
+
+uint8 KEYPAD_getPressedKey(void)
+{
+	KEYPAD_Event event;
+
+	TRACE(TRACE_KEY_WAIT, 0);
+	do
+	{
+		KEYPAD_waitEvent(&event);
+	} while(event.type != KEYPAD_PRESS);
+
+	/* Stamped as the press is taken, so keys typed ahead don't restart the one being shown */
+	Latency_start(LATENCY_KEY_ECHO);     /* Until the application shows the key */
+	TRACE(TRACE_KEY, event.key);
+	return event.key;
+}
+
+uint8 KEYPAD_isLongPress(uint8 key)
+{
+	KEYPAD_Event event;
+
+	do
+	{
+		KEYPAD_waitEvent(&event);
+	} while((event.key != key) || (event.type == KEYPAD_PRESS));
+
+	return (event.type == KEYPAD_LONG_PRESS);
+}
+
+#if (KEYPAD_WAKE_ENABLE == TRUE)
+static void KEYPAD_enterIdle(void)
+{
+	Timer_deInit(KEYPAD_TIMER_ID);
 
+	/* Drive all the rows, any press now pulls its column and the wake-up line */
+	GPIO_DDR_REG(KEYPAD_ROW_PORT_ID) |= KEYPAD_ROWS_BITS;
+
+	SET_BIT(GIFR, INTF0);	/* Clear any old edge */
+	SET_BIT(GICR, INT0);
+
+	/* A key pressed before the interrupt was armed gives no edge, wake up right away */
+	if(GPIO_READ_PIN(KEYPAD_WAKE_PORT_ID, KEYPAD_WAKE_PIN_ID) == LOGIC_LOW)
+	{
+		CLEAR_BIT(GICR, INT0);
+		GPIO_DDR_REG(KEYPAD_ROW_PORT_ID) &= ~KEYPAD_ROWS_BITS;
+		Timer_init(&g_scanTimer);
+	}
+	g_quietTicks = 0;
+}
+#endif
+
+static void KEYPAD_pushEvent(uint8 key, KEYPAD_EventType type)
+{
+	uint8 head = g_eventHead;
+	uint8 next = (head + 1) & (KEYPAD_EVENT_QUEUE_SIZE - 1);
+
+	/* Queue full, the newest event is dropped */
+	if(next == g_eventTail)
+	{
+		return;
+	}
+
+	g_eventQueue[head].key = key;
+	g_eventQueue[head].type = type;
+	if(type == KEYPAD_PRESS)
+	{
+		TRACE(TRACE_KEY_PRESS, key);
+	}
+
+	/* Publish the slot only after it has been filled */
+	g_eventHead = next;
+}
+
+static uint16 KEYPAD_scanMatrix(void)
+{
+	uint8 row, cols;
+	uint8 rowBit = (1 << KEYPAD_FIRST_ROW_PIN_ID);
+	uint16 pressed = 0;
+	for(row=0 ; row<KEYPAD_NUM_ROWS ; row++, rowBit <<= 1) /* loop for rows */
+	{
+		/* Drive only this row to the pressed level (its latch already holds it) */
+		GPIO_DDR_REG(KEYPAD_ROW_PORT_ID) |= rowBit;
+
+		/* Let the level pass the input synchronizer, then read all the columns at once */
+		__asm__ __volatile__ ("nop");
+		cols = GPIO_READ_PORT(KEYPAD_COL_PORT_ID);
+
+		GPIO_DDR_REG(KEYPAD_ROW_PORT_ID) &= ~rowBit;
+
+#if (KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+		cols = ~cols;
 #endif
+		cols = (cols >> KEYPAD_FIRST_COL_PIN_ID) & KEYPAD_COLS_MASK;
+
+		pressed |= (uint16)cols << (row*KEYPAD_NUM_COLS);
+	}
+	return pressed;
+}
+
+static uint8 KEYPAD_keyOf(uint8 index)
+{
+	return pgm_read_byte(&g_keymap[0][0] + index);
+}
@@ -14,6 +14,7 @@
 #define KEYPAD_H_
 
 #include "std_types.h"
+#include "Timer.h"
 
 /*******************************************************************************
  *                                Definitions                                  *
@@ -30,18 +31,126 @@
 #define KEYPAD_COL_PORT_ID                PORTB_ID
 #define KEYPAD_FIRST_COL_PIN_ID           PIN4_ID
 
+/*
+ * Keymap descriptions, the key value reported for every switch (row by row).
+ * A layout is swapped by changing KEYPAD_NUM_COLS or pointing KEYPAD_KEYMAP to another description,
+ * the driver turns the selected one into a lookup table in flash.
+ */
+#define KEYPAD_KEYMAP_4x3                          \
+{                                                  \
+	{  1 ,  2 ,  3  },                             \
+	{  4 ,  5 ,  6  },                             \
+	{  7 ,  8 ,  9  },                             \
+	{ '*',  0 , '#' }                              \
+}
+
+#define KEYPAD_KEYMAP_4x4                          \
+{                                                  \
+	{  7 ,  8 ,  9 , '%' },                        \
+	{  4 ,  5 ,  6 , '*' },                        \
+	{  1 ,  2 ,  3 , '-' },                        \
+	{  13,  0 , '=', '+' }  /* 13: ASCII of Enter */\
+}
+
+#if (KEYPAD_NUM_COLS == 3)
+#define KEYPAD_KEYMAP                    KEYPAD_KEYMAP_4x3
+#elif (KEYPAD_NUM_COLS == 4)
+#define KEYPAD_KEYMAP                    KEYPAD_KEYMAP_4x4
+#endif
+
 /* Keypad button logic configurations */
 #define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
 #define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
 
+/* Keypad service configurations (KEYPAD_scanTick() runs every ~10ms) */
+#define KEYPAD_TIMER_ID                  Timer_0
+#define KEYPAD_TIMER_CLOCK               Fcpu_1024
+#define KEYPAD_TIMER_COMPARE_VALUE       78     /* 8MHz / 1024 / (78 + 1) = ~10ms */
+#define KEYPAD_EVENT_QUEUE_SIZE          16     /* Must be a power of 2 */
+#define KEYPAD_LONG_PRESS_TICKS          100    /* Held for 100 ticks (~1s) reports a long press */
+#define KEYPAD_NO_KEY                    0xFF
+
+/*
+ * Debounce configurations, every key has an integrator counting up on each pressed sample
+ * and down on each released sample (saturating at 0 and KEYPAD_DEBOUNCE_MAX).
+ * The key becomes pressed when it reaches KEYPAD_PRESS_THRESHOLD and released when it
+ * falls to KEYPAD_RELEASE_THRESHOLD, so each physical press is reported exactly once.
+ */
+#define KEYPAD_DEBOUNCE_MAX              4
+#define KEYPAD_PRESS_THRESHOLD           3      /* ~30ms of contact */
+#define KEYPAD_RELEASE_THRESHOLD         0      /* ~40ms without contact after a full press (MAX - RELEASE scans) */
+
+/*
+ * Idle mode configurations, after KEYPAD_IDLE_TICKS ticks with every switch released the scan
+ * stops, all the rows are driven to the pressed level and the columns (diode-OR'd to the INT0 pin)
+ * wake the service up with an external interrupt as soon as any key is touched.
+ * INT2 (PB2) can't be used since it is a keypad row.
+ * The wake-up line is not in the Proteus schematic, so the idle mode is off unless built with
+ * -DKEYPAD_WAKE_ENABLE=TRUE for a board that has it: the scan then never stops (the CPU still
+ * sleeps between two ticks) and the INT0 pin is left alone.
+ */
+#ifndef KEYPAD_WAKE_ENABLE
+#define KEYPAD_WAKE_ENABLE               FALSE
+#endif
+#define KEYPAD_WAKE_PORT_ID              PORTD_ID
+#define KEYPAD_WAKE_PIN_ID               PIN2_ID  /* INT0 */
+#define KEYPAD_IDLE_TICKS                10
+
+#if (KEYPAD_RELEASE_THRESHOLD >= KEYPAD_PRESS_THRESHOLD) || (KEYPAD_PRESS_THRESHOLD > KEYPAD_DEBOUNCE_MAX)
+#error "Keypad debounce thresholds must satisfy RELEASE < PRESS <= MAX"
+#endif
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum
+{
+	KEYPAD_PRESS,KEYPAD_RELEASE,KEYPAD_LONG_PRESS
+}KEYPAD_EventType;
+
+typedef struct
+{
+	uint8 key;                 /* Key value as returned by KEYPAD_getPressedKey() */
+	KEYPAD_EventType type;
+}KEYPAD_Event;
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
 /*
  * Description :
- * Get the Keypad pressed button
+ * Setup the keypad pins, empty the event queue and start the periodic scan on KEYPAD_TIMER_ID.
+ * Global interrupts must be enabled by the application.
+ */
+void KEYPAD_init(void);
+
+/*
+ * Description :
+ * Scan the keypad once and push the press/release/long-press events into the queue.
+ * Called from the KEYPAD_TIMER_ID interrupt.
+ */
+void KEYPAD_scanTick(void);
+
+/*
+ * Description :
+ * Take the oldest key event from the queue, never blocks.
+ * Returns TRUE if an event was copied into the given pointer, FALSE if the queue is empty.
+ */
+uint8 KEYPAD_getEvent(KEYPAD_Event *event);
+
+/*
+ * Description :
+ * Get the Keypad pressed button (waits for the next press event in the queue),
+ * the CPU sleeps in idle mode while there is nothing to do.
  */
 uint8 KEYPAD_getPressedKey(void);
 
+/*
+ * Description :
+ * Wait for the end of the press of the given key, just returned by KEYPAD_getPressedKey().
+ * Returns TRUE if it was held for a long press (KEYPAD_LONG_PRESS_TICKS), FALSE if it was released before.
+ */
+uint8 KEYPAD_isLongPress(uint8 key);
+
 #endif /* KEYPAD_H_ */
@@ -0,0 +1,187 @@
+/*
+ * bench.c
+ *
+ *  Benchmark framework, see bench.h.
+ *  Built once per ECU with the include path of that ECU, so Timer and UART are its own drivers.
+ */
+
+#include "bench.h"
+#include "common_macros.h"
+#include "Timer.h"
+#include "UART.h"
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* End of the static data, the free RAM runs from here up to the stack pointer */
+extern uint8 __heap_start;
+
+static volatile uint16 g_overflows = 0;   /* Timer1 overflows, upper half of the cycle count */
+static uint32 g_overhead = 0;             /* Cycles of an empty case */
+static uint8 *g_stackBase;                /* Stack pointer right before the measured call */
+
+static const Timer_ConfigType g_cycleTimer = {0, 0, Timer_1, Fcpu_1, NORMAL_MODE};
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+static void Bench_overflow(void)
+{
+	g_overflows++;
+}
+
+/* CPU cycles since Bench_init(), an overflow still pending is counted when TCNT1 already wrapped */
+static uint32 Bench_cycles(void)
+{
+	uint8 sreg = SREG;
+	uint16 low, high;
+
+	cli();
+	low = TCNT1;
+	high = g_overflows;
+	if(BIT_IS_SET(TIFR, TOV1) && (low < 0x8000))
+	{
+		high++;
+	}
+	SREG = sreg;
+
+	return ((uint32)high << 16) | low;
+}
+
+static void Bench_nothing(void)
+{
+}
+
+/* Fill the free RAM (up to the current stack pointer) with the paint pattern */
+static inline void Bench_paintStack(void) __attribute__((always_inline));
+static inline void Bench_paintStack(void)
+{
+	uint8 *address = &__heap_start;
+
+	g_stackBase = (uint8 *)SP + 1;   /* SP points to the next free byte */
+	while(address < g_stackBase)
+	{
+		*address++ = BENCH_PAINT;
+	}
+}
+
+/* Bytes below the paint base that don't hold the pattern anymore */
+static uint16 Bench_stackUsed(void)
+{
+	uint8 *address = &__heap_start;
+
+	while((address < g_stackBase) && (*address == BENCH_PAINT))
+	{
+		address++;
+	}
+	return (uint16)(g_stackBase - address);
+}
+
+static void Bench_sendNumber(uint32 value)
+{
+	char text[11];
+
+	ultoa(value, text, 10);
+	UART_sendString((const uint8 *)text);
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Bench_init(void)
+{
+	UART_Config link = {BENCH_BAUD_RATE, DISABLED, EIGHT_BITS, ONE_BIT};
+	uint32 start;
+
+	UART_Init(&link);
+	Timer_setCallBack(Bench_overflow, Timer_1);
+	Timer_init(&g_cycleTimer);
+	sei();
+
+	/* Cost of reading the counter and calling a case */
+	start = Bench_cycles();
+	Bench_nothing();
+	g_overhead = Bench_cycles() - start;
+}
+
+void Bench_run(const Bench_CaseType *benchCase)
+{
+	uint32 start, cycles, fastest = 0xFFFFFFFF;
+	uint16 stack, deepest = 0;
+	uint8 run;
+
+	for(run=0 ; run<BENCH_RUNS ; run++)
+	{
+		if(benchCase->prepare != NULL_PTR)
+		{
+			benchCase->prepare();
+		}
+
+		Bench_paintStack();
+		start = Bench_cycles();
+		benchCase->run();
+		cycles = Bench_cycles() - start;
+		stack = Bench_stackUsed();
+
+		cycles = (cycles > g_overhead) ? (cycles - g_overhead) : 0;
+		fastest = (cycles < fastest) ? cycles : fastest;
+		deepest = (stack > deepest) ? stack : deepest;
+	}
+
+	UART_sendString((const uint8 *)"bench ");
+	UART_sendString((const uint8 *)benchCase->name);
+	UART_sendByte(' ');
+	Bench_sendNumber(fastest);
+	UART_sendByte(' ');
+	Bench_sendNumber(deepest);
+	UART_sendString((const uint8 *)"\r\n");
+}
+
+void Bench_request(const uint8 *bytes, uint8 count)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	uint8 index;
+
+	/* Anything left from a previous case */
+	while(BIT_IS_SET(UCSRA, UART_RECEIVE_COMPLETE))
+	{
+		(void)UDR;
+	}
+
+	UART_sendString((const uint8 *)"input ");
+	for(index=0 ; index<count ; index++)
+	{
+		UART_sendByte(hex[bytes[index] >> 4]);
+		UART_sendByte(hex[bytes[index] & 0x0F]);
+	}
+	UART_sendString((const uint8 *)"\r\n");
+
+	while(BIT_IS_CLEAR(UCSRA, UART_RECEIVE_COMPLETE))
+	{
+		/* Wait for the runner */
+	}
+}
+
+void Bench_done(void)
+{
+	UART_sendString((const uint8 *)"done\r\n");
+
+	/* Let the last byte leave before stopping */
+	SET_BIT(UCSRA, UART_TRANSMIT_COMPLETE);
+	while(BIT_IS_CLEAR(UCSRA, UART_TRANSMIT_COMPLETE))
+	{
+	}
+
+	cli();
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	sleep_enable();
+	sleep_cpu();
+}
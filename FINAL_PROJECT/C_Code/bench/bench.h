@@ -0,0 +1,68 @@
+/*
+ * bench.h
+ *
+ *  Benchmark framework for the ECU drivers, built into the bench firmwares (bench_hmi.c,
+ *  bench_control.c) together with the real objects of one ECU.
+ *
+ *  Every case runs BENCH_RUNS times and is measured with Timer1 counting CPU cycles
+ *  (no prescaler, overflows counted in its interrupt), the stack used is found by painting
+ *  the free RAM before the run and looking for the deepest byte overwritten. The results go
+ *  out on the UART as text lines read by the simavr runner (simavr_bench.c):
+ *    "bench <name> <cycles> <stack bytes>"   fastest run, deepest stack of the runs
+ *    "input <hex bytes>"                     the case waits for these bytes on the UART
+ *    "done"                                  every case ran, the CPU stops
+ *  The same firmware runs on the board, the lines are then read with any serial terminal.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define BENCH_RUNS                     3
+#define BENCH_PAINT                    0xA5   /* Pattern of the free RAM before a run */
+#define BENCH_BAUD_RATE                9600   /* Same link as the applications */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	const char *name;          /* Reported name, the function measured (its flash size is looked up by name) */
+	void (*prepare)(void);     /* Called before every run, not measured (NULL_PTR if nothing to do) */
+	void (*run)(void);         /* The measured operation */
+} Bench_CaseType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start the cycle counter (Timer1) and the UART, enable the interrupts and measure the cost
+ * of the measurement itself, which is taken off every result.
+ */
+void Bench_init(void);
+
+/*
+ * Description :
+ * Run one case and report its line.
+ */
+void Bench_run(const Bench_CaseType *benchCase);
+
+/*
+ * Description :
+ * Ask the runner for bytes on the UART, returns once the first one arrived.
+ */
+void Bench_request(const uint8 *bytes, uint8 count);
+
+/*
+ * Description :
+ * Report the end of the cases and stop the CPU (sleep with the interrupts disabled).
+ */
+void Bench_done(void);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,114 @@
+/*
+ * bench_control.c
+ *
+ *  Benchmark firmware of the Control ECU drivers (EEPROM over I2C, UART) and of the password
+ *  check of the application, linked with the Control objects (Main_App_Control.c is built with
+ *  its main() renamed). Under simavr the runner answers as a 24C16 on the I2C bus.
+ */
+
+#include "bench.h"
+#include "common_macros.h"
+#include "external_eeprom.h"
+#include "I2C.h"
+#include "UART.h"
+
+#include <avr/io.h>
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define BENCH_EEPROM_ADDRESS           0x0100   /* Away from the password */
+#define BENCH_PASSWORD_ADDRESS         0x0001   /* Where passStoreCheck() keeps it */
+#define BENCH_PASSWORD_LENGTH          5
+
+/* From Main_App_Control.c */
+void passStoreCheck(void);
+
+static const uint8 g_password[BENCH_PASSWORD_LENGTH] = {1, 2, 3, 4, 5};
+
+/* What the HMI sends to check a password: 'F' then the digits */
+static const uint8 g_checkRequest[BENCH_PASSWORD_LENGTH + 1] = {'F', 1, 2, 3, 4, 5};
+
+static uint8 g_byte;
+
+/*******************************************************************************
+ *                                Cases                                        *
+ *******************************************************************************/
+
+/* Let the write cycle of the previous run end (5ms max on a 24C16) */
+static void Bench_eepromWriteCycle(void)
+{
+	_delay_ms(10);
+}
+
+static void Bench_eepromWriteByte(void)
+{
+	(void)EEPROM_writeByte(BENCH_EEPROM_ADDRESS, 0x5A);
+}
+
+static void Bench_eepromReadByte(void)
+{
+	(void)EEPROM_readByte(BENCH_EEPROM_ADDRESS, &g_byte);
+}
+
+static void Bench_waitLinkEmpty(void)
+{
+	while(BIT_IS_CLEAR(UCSRA, UART_DATA_REGISTER_EMPTY))
+	{
+	}
+}
+
+static void Bench_uartSendByte(void)
+{
+	UART_sendByte(' ');
+}
+
+/*
+ * The right password, the measure includes receiving the 5 digits after the 'F'
+ * at BENCH_BAUD_RATE as it does in the application.
+ */
+static void Bench_requestCheck(void)
+{
+	Bench_request(g_checkRequest, sizeof(g_checkRequest));
+}
+
+static void Bench_passStoreCheck(void)
+{
+	passStoreCheck();
+}
+
+static const Bench_CaseType g_cases[] =
+{
+	{"EEPROM_writeByte", Bench_eepromWriteCycle, Bench_eepromWriteByte},
+	{"EEPROM_readByte",  Bench_eepromWriteCycle, Bench_eepromReadByte},
+	{"UART_sendByte",    Bench_waitLinkEmpty,    Bench_uartSendByte},
+	{"passStoreCheck",   Bench_requestCheck,     Bench_passStoreCheck},
+};
+
+/*******************************************************************************
+ *                                 Main                                        *
+ *******************************************************************************/
+int main(void)
+{
+	I2C_Config i2c = {CPU_8MHZ, I2C_400KHZ, 0xAA};  /* Same bus setup as the application */
+	uint8 index;
+
+	I2C_init(&i2c);
+	Bench_init();
+
+	/* The password passStoreCheck() compares with */
+	for(index=0 ; index<BENCH_PASSWORD_LENGTH ; index++)
+	{
+		(void)EEPROM_writeByte(BENCH_PASSWORD_ADDRESS + index, g_password[index]);
+		_delay_ms(10);
+	}
+
+	for(index=0 ; index<(sizeof(g_cases)/sizeof(g_cases[0])) ; index++)
+	{
+		Bench_run(&g_cases[index]);
+	}
+
+	Bench_done();
+	return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * bench_hmi.c
+ *
+ *  Benchmark firmware of the HMI ECU drivers (LCD, keypad, UART), linked with the HMI objects.
+ *  Under simavr the runner holds one key of the keypad down for the whole run.
+ */
+
+#include "bench.h"
+#include "common_macros.h"
+#include "keypad.h"
+#include "LCD.h"
+#include "Timer.h"
+#include "UART.h"
+
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                                Cases                                        *
+ *******************************************************************************/
+
+static void Bench_homeCursor(void)
+{
+	LCD_MoveCursor(0, 0);
+}
+
+static void Bench_lcdSendCharacter(void)
+{
+	LCD_SendCharacter('*');
+}
+
+static void Bench_lcdSendString(void)
+{
+	LCD_SendString("Door Unlocking  ");
+}
+
+static void Bench_waitLinkEmpty(void)
+{
+	while(BIT_IS_CLEAR(UCSRA, UART_DATA_REGISTER_EMPTY))
+	{
+	}
+}
+
+static void Bench_uartSendByte(void)
+{
+	UART_sendByte(' ');
+}
+
+/* The scan tick alone, its timer stopped so it only runs when called */
+static void Bench_keypadStopScan(void)
+{
+	KEYPAD_init();
+	Timer_deInit(KEYPAD_TIMER_ID);
+}
+
+static void Bench_keypadScanTick(void)
+{
+	KEYPAD_scanTick();
+}
+
+/* Fresh debounce state and the scan running, the held key is reported after the press threshold */
+static void Bench_keypadInit(void)
+{
+	KEYPAD_init();
+}
+
+static void Bench_keypadGetPressedKey(void)
+{
+	(void)KEYPAD_getPressedKey();
+}
+
+static const Bench_CaseType g_cases[] =
+{
+	{"LCD_SendCharacter",    Bench_homeCursor,     Bench_lcdSendCharacter},
+	{"LCD_SendString",       Bench_homeCursor,     Bench_lcdSendString},
+	{"UART_sendByte",        Bench_waitLinkEmpty,  Bench_uartSendByte},
+	{"KEYPAD_scanTick",      Bench_keypadStopScan, Bench_keypadScanTick},
+	{"KEYPAD_getPressedKey", Bench_keypadInit,     Bench_keypadGetPressedKey},
+};
+
+/*******************************************************************************
+ *                                 Main                                        *
+ *******************************************************************************/
+int main(void)
+{
+	uint8 index;
+
+	LCD_init();
+	Bench_init();
+
+	for(index=0 ; index<(sizeof(g_cases)/sizeof(g_cases[0])) ; index++)
+	{
+		Bench_run(&g_cases[index]);
+	}
+
+	Bench_done();
+	return 0;
+}
@@ -0,0 +1,439 @@
+/*
+ * simavr_bench.c
+ *
+ *  Runs the bench firmwares (bench_hmi.elf, bench_control.elf) under simavr and writes their
+ *  results as JSON. Peripheral stubs attached to the simulated ATmega32:
+ *  - UART: the lines of the firmware are parsed (see bench.h), "input" requests are answered.
+ *  - I2C: a 24C16 EEPROM (2KB, 16 byte write pages, device address 0xA0 | A10..A8).
+ *  - Keypad: one key (row, column) held down, its column follows the row strobe, and the
+ *    INT0 wake-up line (used by KEYPAD_WAKE_ENABLE builds) is pulled low while the row is driven.
+ *
+ *  usage: simavr-bench [-o results.json] [-k row,col] [-c max-cycles] firmware.elf...
+ *    The flash of every case is the size of the function of the same name, read from
+ *    firmware.sym next to the ELF ("avr-nm --print-size --radix=d" output).
+ */
+
+#include <simavr/avr_ioport.h>
+#include <simavr/avr_twi.h>
+#include <simavr/avr_uart.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define SIMBENCH_MCU                   "atmega32"
+#define SIMBENCH_F_CPU                 8000000
+#define SIMBENCH_MAX_CYCLES            (60ULL * SIMBENCH_F_CPU)   /* A minute of CPU time per firmware */
+#define SIMBENCH_MAX_CASES             32
+#define SIMBENCH_LINE_SIZE             128
+#define SIMBENCH_NAME_SIZE             48
+
+#define SIMBENCH_EEPROM_SIZE           2048
+#define SIMBENCH_EEPROM_PAGE           16
+#define SIMBENCH_EEPROM_DEVICE         0xA0
+#define SIMBENCH_EEPROM_DEVICE_MASK    0xF0
+
+#define SIMBENCH_KEYPAD_PORT           'B'
+#define SIMBENCH_KEYPAD_FIRST_ROW      0
+#define SIMBENCH_KEYPAD_FIRST_COL      4
+#define SIMBENCH_KEYPAD_NUM_COLS       4
+#define SIMBENCH_WAKE_PORT             'D'
+#define SIMBENCH_WAKE_PIN              2
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	char name[SIMBENCH_NAME_SIZE];
+	unsigned long cycles;
+	unsigned long stack;
+	long flash;                 /* -1 when the symbol isn't found */
+} SimBench_ResultType;
+
+typedef struct
+{
+	uint8_t memory[SIMBENCH_EEPROM_SIZE];
+	uint8_t selected;           /* Device address byte of the transfer, 0 when not addressed */
+	uint8_t wordAddressSent;    /* The first written byte (the word address) was received */
+	uint16_t address;
+} SimBench_EepromType;
+
+typedef struct
+{
+	uint8_t row, col;           /* Held key */
+	uint8_t ddr, port;          /* Last values of the keypad port registers */
+} SimBench_KeypadType;
+
+typedef struct
+{
+	avr_t *avr;
+	char line[SIMBENCH_LINE_SIZE];
+	size_t length;
+	int done;
+	SimBench_ResultType results[SIMBENCH_MAX_CASES];
+	size_t count;
+	SimBench_EepromType eeprom;
+	SimBench_KeypadType keypad;
+} SimBench_TargetType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint8_t g_keyRow = 1, g_keyCol = 1;    /* '5' on the 4x4 keypad */
+static unsigned long long g_maxCycles = SIMBENCH_MAX_CYCLES;
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+/* "input <hex>": queue the bytes on the UART input, simavr delivers them at the baud rate */
+static void SimBench_input(SimBench_TargetType *target, const char *hex)
+{
+	avr_irq_t *input = avr_io_getirq(target->avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+	unsigned int byte;
+
+	while(sscanf(hex, "%2x", &byte) == 1)
+	{
+		avr_raise_irq(input, byte);
+		hex += 2;
+	}
+}
+
+static void SimBench_line(SimBench_TargetType *target, const char *line)
+{
+	SimBench_ResultType *result;
+	const char *found;
+
+	/* Bytes the application itself sends (passStoreCheck answers 'X') can come first */
+	if((found = strstr(line, "bench ")) != NULL)
+	{
+		if(target->count == SIMBENCH_MAX_CASES)
+		{
+			return;
+		}
+		result = &target->results[target->count];
+		if(sscanf(found, "bench %47s %lu %lu", result->name, &result->cycles, &result->stack) == 3)
+		{
+			result->flash = -1;
+			target->count++;
+		}
+	}
+	else if((found = strstr(line, "input ")) != NULL)
+	{
+		SimBench_input(target, found + strlen("input "));
+	}
+	else if(strstr(line, "done") != NULL)
+	{
+		target->done = 1;
+	}
+}
+
+static void SimBench_uartOutput(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+	SimBench_TargetType *target = param;
+	char character = (char)value;
+
+	(void)irq;
+	if(character == '\n')
+	{
+		target->line[target->length] = '\0';
+		SimBench_line(target, target->line);
+		target->length = 0;
+	}
+	else if((character != '\r') && (target->length < SIMBENCH_LINE_SIZE - 1))
+	{
+		target->line[target->length++] = character;
+	}
+}
+
+/* 24C16 slave: ACK its device addresses, first written byte is the word address (A7..A0) */
+static void SimBench_twi(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+	SimBench_TargetType *target = param;
+	SimBench_EepromType *eeprom = &target->eeprom;
+	avr_irq_t *input = avr_io_getirq(target->avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT);
+	avr_twi_msg_irq_t message;
+	uint16_t page;
+
+	(void)irq;
+	message.u.v = value;
+
+	if(message.u.twi.msg & TWI_COND_STOP)
+	{
+		eeprom->selected = 0;
+	}
+
+	if(message.u.twi.msg & TWI_COND_ADDR)
+	{
+		eeprom->selected = 0;
+		if((message.u.twi.addr & SIMBENCH_EEPROM_DEVICE_MASK) == SIMBENCH_EEPROM_DEVICE)
+		{
+			eeprom->selected = message.u.twi.addr;
+			eeprom->wordAddressSent = 0;
+			/* A10..A8 come with every device address, A7..A0 stay from the last transfer on a read */
+			eeprom->address = (uint16_t)(((message.u.twi.addr >> 1) & 0x07) << 8) | (eeprom->address & 0xFF);
+			avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_ACK, eeprom->selected, 1));
+		}
+	}
+
+	if(!eeprom->selected)
+	{
+		return;
+	}
+
+	if(message.u.twi.msg & TWI_COND_WRITE)
+	{
+		avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_ACK, eeprom->selected, 1));
+		if(!eeprom->wordAddressSent)
+		{
+			eeprom->address = (eeprom->address & 0x0700) | message.u.twi.data;
+			eeprom->wordAddressSent = 1;
+		}
+		else
+		{
+			/* Writes roll over inside the page */
+			eeprom->memory[eeprom->address] = message.u.twi.data;
+			page = eeprom->address & ~(SIMBENCH_EEPROM_PAGE - 1);
+			eeprom->address = page | ((eeprom->address + 1) & (SIMBENCH_EEPROM_PAGE - 1));
+		}
+	}
+
+	if(message.u.twi.msg & TWI_COND_READ)
+	{
+		avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_READ, eeprom->selected, eeprom->memory[eeprom->address]));
+		eeprom->address = (eeprom->address + 1) & (SIMBENCH_EEPROM_SIZE - 1);
+	}
+}
+
+/* Held key: its column (and the wake-up line) is low while its row is driven low */
+static void SimBench_keypadUpdate(SimBench_TargetType *target)
+{
+	SimBench_KeypadType *keypad = &target->keypad;
+	uint8_t rowBit = 1 << (SIMBENCH_KEYPAD_FIRST_ROW + keypad->row);
+	uint8_t pressed = (keypad->ddr & rowBit) && !(keypad->port & rowBit);
+	uint8_t col;
+
+	for(col=0 ; col<SIMBENCH_KEYPAD_NUM_COLS ; col++)
+	{
+		avr_raise_irq(avr_io_getirq(target->avr, AVR_IOCTL_IOPORT_GETIRQ(SIMBENCH_KEYPAD_PORT),
+				SIMBENCH_KEYPAD_FIRST_COL + col), (pressed && (col == keypad->col)) ? 0 : 1);
+	}
+	avr_raise_irq(avr_io_getirq(target->avr, AVR_IOCTL_IOPORT_GETIRQ(SIMBENCH_WAKE_PORT), SIMBENCH_WAKE_PIN),
+			pressed ? 0 : 1);
+}
+
+static void SimBench_keypadDirection(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+	SimBench_TargetType *target = param;
+
+	(void)irq;
+	target->keypad.ddr = (uint8_t)value;
+	SimBench_keypadUpdate(target);
+}
+
+static void SimBench_keypadPort(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+	SimBench_TargetType *target = param;
+
+	(void)irq;
+	target->keypad.port = (uint8_t)value;
+	SimBench_keypadUpdate(target);
+}
+
+static void SimBench_attach(SimBench_TargetType *target)
+{
+	avr_t *avr = target->avr;
+	uint32_t flags = 0;
+
+	/* UART lines to the parser instead of simavr's console */
+	avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+	flags &= ~AVR_UART_FLAG_STDIO;
+	avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT),
+			SimBench_uartOutput, target);
+
+	/* Blank EEPROM on the I2C bus */
+	memset(target->eeprom.memory, 0xFF, sizeof(target->eeprom.memory));
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT),
+			SimBench_twi, target);
+
+	/* Keypad, the columns and the wake-up line idle high */
+	target->keypad.row = g_keyRow;
+	target->keypad.col = g_keyCol;
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(SIMBENCH_KEYPAD_PORT), IOPORT_IRQ_DIRECTION_ALL),
+			SimBench_keypadDirection, target);
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(SIMBENCH_KEYPAD_PORT), IOPORT_IRQ_REG_PORT),
+			SimBench_keypadPort, target);
+	SimBench_keypadUpdate(target);
+}
+
+/* Flash of every case from the symbol sizes next to the ELF (firmware.sym) */
+static void SimBench_flashSizes(SimBench_TargetType *target, const char *elf)
+{
+	char path[4096], line[256], name[256], type;
+	unsigned long address, size;
+	const char *dot = strrchr(elf, '.');
+	FILE *symbols;
+	size_t index;
+
+	snprintf(path, sizeof(path), "%.*s.sym", (int)(dot ? (size_t)(dot - elf) : strlen(elf)), elf);
+	symbols = fopen(path, "r");
+	if(symbols == NULL)
+	{
+		fprintf(stderr, "simavr-bench: no %s, flash sizes left out\n", path);
+		return;
+	}
+
+	while(fgets(line, sizeof(line), symbols) != NULL)
+	{
+		if(sscanf(line, "%lu %lu %c %255s", &address, &size, &type, name) != 4)
+		{
+			continue;
+		}
+		for(index=0 ; index<target->count ; index++)
+		{
+			if(strcmp(target->results[index].name, name) == 0)
+			{
+				target->results[index].flash = (long)size;
+			}
+		}
+	}
+	fclose(symbols);
+}
+
+static int SimBench_run(const char *elf, FILE *json, int first)
+{
+	static SimBench_TargetType target;
+	elf_firmware_t firmware;
+	char name[SIMBENCH_NAME_SIZE];
+	const char *base = strrchr(elf, '/');
+	int state = cpu_Running;
+	size_t index;
+
+	memset(&firmware, 0, sizeof(firmware));
+	if(elf_read_firmware(elf, &firmware) != 0)
+	{
+		fprintf(stderr, "simavr-bench: can't read %s\n", elf);
+		return -1;
+	}
+	if(firmware.mmcu[0] == '\0')
+	{
+		strcpy(firmware.mmcu, SIMBENCH_MCU);
+	}
+	if(firmware.frequency == 0)
+	{
+		firmware.frequency = SIMBENCH_F_CPU;
+	}
+
+	memset(&target, 0, sizeof(target));
+	target.avr = avr_make_mcu_by_name(firmware.mmcu);
+	if(target.avr == NULL)
+	{
+		fprintf(stderr, "simavr-bench: no simavr core for %s\n", firmware.mmcu);
+		return -1;
+	}
+	avr_init(target.avr);
+	avr_load_firmware(target.avr, &firmware);
+	SimBench_attach(&target);
+
+	while(!target.done && (state != cpu_Done) && (state != cpu_Crashed) && (target.avr->cycle < g_maxCycles))
+	{
+		state = avr_run(target.avr);
+	}
+	if(!target.done)
+	{
+		fprintf(stderr, "simavr-bench: %s stopped after %llu cycles without finishing (%zu cases)\n",
+				elf, (unsigned long long)target.avr->cycle, target.count);
+	}
+
+	SimBench_flashSizes(&target, elf);
+
+	/* One object per firmware, named after the ELF */
+	snprintf(name, sizeof(name), "%s", base ? base + 1 : elf);
+	if(strrchr(name, '.') != NULL)
+	{
+		*strrchr(name, '.') = '\0';
+	}
+	fprintf(json, "%s    {\n      \"firmware\": \"%s\",\n      \"flash\": %u,\n      \"complete\": %s,\n      \"cases\": [\n",
+			first ? "" : ",\n", name, (unsigned)firmware.flashsize, target.done ? "true" : "false");
+	for(index=0 ; index<target.count ; index++)
+	{
+		fprintf(json, "        {\"name\": \"%s\", \"cycles\": %lu, \"us\": %.1f, \"stack\": %lu, \"flash\": %ld}%s\n",
+				target.results[index].name, target.results[index].cycles,
+				target.results[index].cycles * 1e6 / firmware.frequency, target.results[index].stack,
+				target.results[index].flash, (index + 1 < target.count) ? "," : "");
+		printf("%-14s %-22s %10lu cycles %9.1f us %5lu B stack %6ld B flash\n", name,
+				target.results[index].name, target.results[index].cycles,
+				target.results[index].cycles * 1e6 / firmware.frequency,
+				target.results[index].stack, target.results[index].flash);
+	}
+	fprintf(json, "      ]\n    }");
+
+	avr_terminate(target.avr);
+	return target.done ? 0 : -1;
+}
+
+/*******************************************************************************
+ *                                 Main                                        *
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+	const char *output = "bench_results.json";
+	unsigned int row, col;
+	int option, index, status = 0;
+	FILE *json;
+
+	while((option = getopt(argc, argv, "o:k:c:")) != -1)
+	{
+		switch(option)
+		{
+		case 'o':
+			output = optarg;
+			break;
+		case 'k':
+			if(sscanf(optarg, "%u,%u", &row, &col) == 2)
+			{
+				g_keyRow = (uint8_t)row;
+				g_keyCol = (uint8_t)col;
+			}
+			break;
+		case 'c':
+			g_maxCycles = strtoull(optarg, NULL, 0);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-o results.json] [-k row,col] [-c max-cycles] firmware.elf...\n", argv[0]);
+			return 2;
+		}
+	}
+	if(optind == argc)
+	{
+		fprintf(stderr, "usage: %s [-o results.json] [-k row,col] [-c max-cycles] firmware.elf...\n", argv[0]);
+		return 2;
+	}
+
+	json = fopen(output, "w");
+	if(json == NULL)
+	{
+		perror(output);
+		return 1;
+	}
+	fprintf(json, "{\n  \"mcu\": \"%s\",\n  \"f_cpu\": %d,\n  \"firmwares\": [\n", SIMBENCH_MCU, SIMBENCH_F_CPU);
+	for(index=optind ; index<argc ; index++)
+	{
+		if(SimBench_run(argv[index], json, index == optind) != 0)
+		{
+			status = 1;
+		}
+	}
+	fprintf(json, "\n  ]\n}\n");
+	fclose(json);
+
+	return status;
+}
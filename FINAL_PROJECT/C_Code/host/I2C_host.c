@@ -0,0 +1,151 @@
+/*
+ * I2C_host.c
+ *
+ *  Host backend of the I2C driver with a 24C16 EEPROM (2KB, 16 byte pages) on the bus,
+ *  I2C_getStatus() returns the TWSR codes the chip would give for every step of a transfer.
+ *
+ *  DOORLOCK_EEPROM_FILE : file holding the memory content (created filled with 0xFF),
+ *                         without it the memory is blank at every start.
+ */
+
+#include "I2C.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define I2C_HOST_EEPROM_SIZE           2048
+#define I2C_HOST_EEPROM_PAGE           16
+#define I2C_HOST_EEPROM_ADDRESS        0xA0     /* 1010 A10 A9 A8 R/W */
+
+#define I2C_HOST_MT_SLA_W_NACK         0x20
+#define I2C_HOST_MT_SLA_R_NACK         0x48
+#define I2C_HOST_MT_DATA_NACK          0x30
+#define I2C_HOST_NO_INFO               0xF8
+
+typedef enum
+{
+	I2C_HOST_IDLE,         /* Bus free */
+	I2C_HOST_ADDRESSING,   /* START sent, next byte is the device address */
+	I2C_HOST_WORD_ADDRESS, /* Device selected for writing, next byte is the word address */
+	I2C_HOST_WRITING,      /* Next bytes are written in the page */
+	I2C_HOST_READING,      /* Device selected for reading */
+	I2C_HOST_IGNORED       /* Another device was addressed */
+} I2C_HostStateType;
+
+static uint8 g_memory[I2C_HOST_EEPROM_SIZE];
+static uint16 g_address = 0;
+static I2C_HostStateType g_state = I2C_HOST_IDLE;
+static uint8 g_status = I2C_HOST_NO_INFO;
+static int g_memoryFd = -1;
+
+void I2C_init(I2C_Config *I2CPtr)
+{
+	const char *path = getenv("DOORLOCK_EEPROM_FILE");
+
+	(void)I2CPtr;
+	memset(g_memory, 0xFF, sizeof(g_memory));
+	if(path != NULL)
+	{
+		g_memoryFd = open(path, O_RDWR | O_CREAT, 0644);
+		if((g_memoryFd >= 0) && (pread(g_memoryFd, g_memory, sizeof(g_memory), 0) != sizeof(g_memory)))
+		{
+			/* New (or short) file, store the blank memory */
+			memset(g_memory, 0xFF, sizeof(g_memory));
+			if(pwrite(g_memoryFd, g_memory, sizeof(g_memory), 0) != sizeof(g_memory))
+			{
+				close(g_memoryFd);
+				g_memoryFd = -1;
+			}
+		}
+	}
+	g_state = I2C_HOST_IDLE;
+}
+
+void I2C_start(void)
+{
+	g_status = (g_state == I2C_HOST_IDLE) ? I2C_START : I2C_REP_START;
+	g_state = I2C_HOST_ADDRESSING;
+}
+
+void I2C_stop(void)
+{
+	g_state = I2C_HOST_IDLE;
+	g_status = I2C_HOST_NO_INFO;
+}
+
+void I2C_writeByte(uint8 data)
+{
+	switch(g_state)
+	{
+	case I2C_HOST_ADDRESSING:
+		if((data & 0xF0) != I2C_HOST_EEPROM_ADDRESS)
+		{
+			g_status = (data & 1) ? I2C_HOST_MT_SLA_R_NACK : I2C_HOST_MT_SLA_W_NACK;
+			g_state = I2C_HOST_IGNORED;
+		}
+		else if(data & 1)
+		{
+			g_status = I2C_MT_SLA_R_ACK;
+			g_state = I2C_HOST_READING;
+		}
+		else
+		{
+			/* The block bits of the device address are the high bits of the word address */
+			g_address = (uint16)(data & 0x0E) << 7;
+			g_status = I2C_MT_SLA_W_ACK;
+			g_state = I2C_HOST_WORD_ADDRESS;
+		}
+		break;
+
+	case I2C_HOST_WORD_ADDRESS:
+		g_address = (g_address & 0x0700) | data;
+		g_status = I2C_MT_DATA_ACK;
+		g_state = I2C_HOST_WRITING;
+		break;
+
+	case I2C_HOST_WRITING:
+		g_memory[g_address] = data;
+		if(g_memoryFd >= 0)
+		{
+			(void)!pwrite(g_memoryFd, &g_memory[g_address], 1, g_address);
+		}
+		/* The address rolls over inside the page */
+		g_address = (g_address & ~(I2C_HOST_EEPROM_PAGE - 1)) | ((g_address + 1) & (I2C_HOST_EEPROM_PAGE - 1));
+		g_status = I2C_MT_DATA_ACK;
+		break;
+
+	default:
+		g_status = I2C_HOST_MT_DATA_NACK;
+		break;
+	}
+}
+
+static uint8 I2C_readByte(uint8 status)
+{
+	uint8 data = 0xFF;
+
+	if(g_state == I2C_HOST_READING)
+	{
+		data = g_memory[g_address];
+		g_address = (g_address + 1) & (I2C_HOST_EEPROM_SIZE - 1);
+	}
+	g_status = status;
+	return data;
+}
+
+uint8 I2C_readByteWithACK(void)
+{
+	return I2C_readByte(I2C_MR_DATA_ACK);
+}
+
+uint8 I2C_readByteWithNACK(void)
+{
+	return I2C_readByte(I2C_MR_DATA_NACK);
+}
+
+uint8 I2C_getStatus(void)
+{
+	return g_status;
+}
@@ -0,0 +1,106 @@
+/*
+ * LCD_host.c
+ *
+ *  Host backend of the LCD bus level functions (replaces LCD_hw.c), models the DDRAM and
+ *  address counter of the HD44780 and prints the first two lines whenever they changed.
+ *
+ *  DOORLOCK_LCD_FD : descriptor the screen is printed to (default stderr).
+ */
+
+#include "LCD.h"
+#include "hal_host.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <util/delay.h>
+
+#define LCD_HOST_DDRAM_SIZE            0x80
+#define LCD_HOST_COLUMNS               16
+
+static uint8 g_ddram[LCD_HOST_DDRAM_SIZE];
+static uint8 g_addressCounter = 0;
+static uint8 g_changed = FALSE;
+static pthread_mutex_t g_lcdLock = PTHREAD_MUTEX_INITIALIZER;
+static FILE *g_screen = NULL;
+
+/* Print the screen from the frame hook, at most once per frame and only after a change */
+static void LCD_refresh(void)
+{
+	uint8 row, col;
+	char text[2][LCD_HOST_COLUMNS + 1];
+	static const uint8 rowAddress[2] = {LCD_First_Row_address, LCD_Second_Row_address};
+
+	pthread_mutex_lock(&g_lcdLock);
+	if(!g_changed)
+	{
+		pthread_mutex_unlock(&g_lcdLock);
+		return;
+	}
+	for(row = 0 ; row < 2 ; row++)
+	{
+		for(col = 0 ; col < LCD_HOST_COLUMNS ; col++)
+		{
+			uint8 character = g_ddram[rowAddress[row] + col];
+			text[row][col] = ((character >= ' ') && (character < 0x7F)) ? (char)character : '?';
+		}
+		text[row][LCD_HOST_COLUMNS] = '\0';
+	}
+	g_changed = FALSE;
+	pthread_mutex_unlock(&g_lcdLock);
+
+	fprintf(g_screen, "[%8.3f] |%s|%s|\n", (double)HostHal_cycles() / F_CPU, text[0], text[1]);
+	fflush(g_screen);
+}
+
+void LCD_init(void)
+{
+	_delay_ms(LCD_POWER_ON_DELAY_MS);
+	LCD_initAfterPowerOn();
+}
+
+void LCD_initAfterPowerOn(void)
+{
+	const char *fd = getenv("DOORLOCK_LCD_FD");
+
+	g_screen = (fd != NULL) ? fdopen(atoi(fd), "w") : NULL;
+	if(g_screen == NULL)
+	{
+		g_screen = stderr;
+	}
+
+	pthread_mutex_lock(&g_lcdLock);
+	memset(g_ddram, ' ', sizeof(g_ddram));
+	g_addressCounter = 0;
+	g_changed = TRUE;
+	pthread_mutex_unlock(&g_lcdLock);
+
+	HostHal_setFrameHook(LCD_refresh);
+}
+
+void LCD_SendCommand(uint8 command)
+{
+	pthread_mutex_lock(&g_lcdLock);
+	if(command & LCD_SET_CURSOR_LOCATION)
+	{
+		g_addressCounter = command & (LCD_HOST_DDRAM_SIZE - 1);
+	}
+	else if(command == LCD_CLEAR_COMMAND)
+	{
+		memset(g_ddram, ' ', sizeof(g_ddram));
+		g_addressCounter = 0;
+		g_changed = TRUE;
+	}
+	/* Function set, display control and the others don't change what is shown */
+	pthread_mutex_unlock(&g_lcdLock);
+}
+
+void LCD_SendCharacter(uint8 character)
+{
+	pthread_mutex_lock(&g_lcdLock);
+	g_ddram[g_addressCounter] = character;
+	g_addressCounter = (g_addressCounter + 1) & (LCD_HOST_DDRAM_SIZE - 1);
+	g_changed = TRUE;
+	pthread_mutex_unlock(&g_lcdLock);
+}
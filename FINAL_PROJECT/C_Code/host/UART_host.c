@@ -0,0 +1,108 @@
+/*
+ * UART_host.c
+ *
+ *  Host backend of the UART driver, the serial line is a file descriptor.
+ *
+ *  DOORLOCK_UART_FD : descriptor used for both directions (a socket connected to the other ECU),
+ *                     without it bytes are received from stdin and sent to stdout.
+ *  The frame settings are ignored, a byte is always sent as one byte.
+ *  The ECU exits when the other end of the line is closed.
+ */
+
+#include "UART.h"
+#include "std_types.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static int g_uartRxFd = STDIN_FILENO;
+static int g_uartTxFd = STDOUT_FILENO;
+static void (*g_callBack)(UART_EventType event, uint8 data) = NULL_PTR;
+
+void UART_Init(UART_Config *UART_configPtr)
+{
+	const char *fd = getenv("DOORLOCK_UART_FD");
+
+	(void)UART_configPtr;
+	if(fd != NULL)
+	{
+		g_uartRxFd = atoi(fd);
+		g_uartTxFd = g_uartRxFd;
+	}
+}
+
+void UART_sendByte(const uint8 data)
+{
+	ssize_t written;
+
+	do
+	{
+		written = write(g_uartTxFd, &data, 1);
+	} while((written < 0) && (errno == EINTR));
+
+	if(written != 1)
+	{
+		exit(EXIT_SUCCESS);
+	}
+	if(g_callBack != NULL_PTR)
+	{
+		(*g_callBack)(UART_EVENT_TX, data);
+	}
+}
+
+uint8 UART_recieveByte(void)
+{
+	uint8 data;
+	ssize_t count;
+
+	if(g_callBack != NULL_PTR)
+	{
+		(*g_callBack)(UART_EVENT_RX_WAIT, 0);
+	}
+	do
+	{
+		count = read(g_uartRxFd, &data, 1);
+	} while((count < 0) && (errno == EINTR));
+
+	if(count != 1)
+	{
+		exit(EXIT_SUCCESS);
+	}
+	if(g_callBack != NULL_PTR)
+	{
+		(*g_callBack)(UART_EVENT_RX, data);
+	}
+	return data;
+}
+
+void UART_sendString(const uint8 *Str)
+{
+	uint8 i = 0;
+
+	/*Send the entire string byte by byte*/
+	while(Str[i] != '\0')
+	{
+		UART_sendByte(Str[i]);
+		i++;
+	}
+}
+
+void UART_receiveString(uint8 *Str)
+{
+	uint8 i = 0;
+
+	/* Receive until the '#' character and replace it with the null terminator */
+	Str[i] = UART_recieveByte();
+	while(Str[i] != '#')
+	{
+		i++;
+		Str[i] = UART_recieveByte();
+	}
+	Str[i] = '\0';
+}
+
+void UART_setCallBack(void(*a_ptr)(UART_EventType event, uint8 data))
+{
+	g_callBack = a_ptr;
+}
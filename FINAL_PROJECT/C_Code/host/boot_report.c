@@ -0,0 +1,165 @@
+/*
+ * boot_report.c
+ *
+ *  Prints the boot profiles dumped by the ECUs (see boot_profile.h).
+ *
+ *  usage: boot-report [capture-file]
+ *    reads the bytes captured on the link (default stdin), finds every frame by its start byte
+ *    and checksum, and prints per boot step the time it ended since the Timer1 start and the time
+ *    it took after the previous one (ms). The other bytes of the capture are ignored.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "boot_profile.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define REPORT_COUNT_MS                (1024.0 * 1000.0 / F_CPU)   /* One Timer1 count (F_CPU/1024) */
+
+/*******************************************************************************
+ *                           Private Variables                                 *
+ *******************************************************************************/
+#define REPORT_NAME_ENTRY(ID, NAME, ECU)   [ID] = NAME,
+static const char *const g_names[BOOT_NUM_OF_STEPS] =
+{
+	BOOT_STEPS(REPORT_NAME_ENTRY)
+};
+#undef REPORT_NAME_ENTRY
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+/* Size of the frame starting at data[0] when it is complete and its checksum is right, else 0 */
+static size_t Report_frameSize(const uint8_t *data, size_t length)
+{
+	size_t size, index;
+	uint8_t checksum = 0;
+
+	if(length < 1 + BOOT_FRAME_HEADER_SIZE + 1)
+	{
+		return 0;
+	}
+	size = 1 + BOOT_FRAME_HEADER_SIZE + 3 * (size_t)data[2] + 1;
+	if(length < size)
+	{
+		return 0;
+	}
+	for(index = 1 ; index < size - 1 ; index++)
+	{
+		checksum += data[index];
+	}
+	return (checksum == data[size - 1]) ? size : 0;
+}
+
+/* Steps of a frame in the order they ended (insertion sort on the time) */
+static unsigned Report_sort(const uint8_t *frame, unsigned *ids, unsigned *times)
+{
+	const uint8_t *step = frame + 1 + BOOT_FRAME_HEADER_SIZE;
+	unsigned count = frame[2], index, slot;
+
+	for(index = 0 ; index < count ; index++, step += 3)
+	{
+		for(slot = index ; (slot > 0) && (times[slot - 1] > (unsigned)(step[1] | (step[2] << 8))) ; slot--)
+		{
+			ids[slot] = ids[slot - 1];
+			times[slot] = times[slot - 1];
+		}
+		ids[slot] = step[0];
+		times[slot] = step[1] | (step[2] << 8);
+	}
+	return count;
+}
+
+static void Report_frame(const uint8_t *frame)
+{
+	unsigned ids[256], times[256], count, index, previous = 0;
+	char unknown[16];
+	const char *name;
+
+	count = Report_sort(frame, ids, times);
+	printf("# ECU %c: %u boot steps (ms from the Timer1 start)\n", frame[1], count);
+	printf("%-10s %9s %9s\n", "step", "at", "took");
+
+	for(index = 0 ; index < count ; index++)
+	{
+		if(ids[index] < BOOT_NUM_OF_STEPS)
+		{
+			name = g_names[ids[index]];
+		}
+		else
+		{
+			snprintf(unknown, sizeof(unknown), "step-%u", ids[index]);
+			name = unknown;
+		}
+		printf("%-10s %9.3f %9.3f\n", name, times[index] * REPORT_COUNT_MS, (times[index] - previous) * REPORT_COUNT_MS);
+		previous = times[index];
+	}
+}
+
+/*******************************************************************************
+ *                                 Main                                        *
+ *******************************************************************************/
+int main(int argc, char **argv)
+{
+	FILE *input = stdin;
+	uint8_t *data = NULL;
+	size_t length = 0, capacity = 0, offset = 0, size;
+	unsigned frames = 0;
+
+	if(argc > 2)
+	{
+		fprintf(stderr, "usage: %s [capture-file]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	if((argc == 2) && ((input = fopen(argv[1], "rb")) == NULL))
+	{
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	for(;;)
+	{
+		if(length == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 4096;
+			if((data = realloc(data, capacity)) == NULL)
+			{
+				perror("realloc");
+				return EXIT_FAILURE;
+			}
+		}
+		size = fread(data + length, 1, capacity - length, input);
+		if(size == 0)
+		{
+			break;
+		}
+		length += size;
+	}
+
+	while(offset < length)
+	{
+		if((data[offset] == BOOT_FRAME_START) && ((size = Report_frameSize(data + offset, length - offset)) != 0))
+		{
+			Report_frame(data + offset);
+			offset += size;
+			frames++;
+		}
+		else
+		{
+			offset++;
+		}
+	}
+
+	free(data);
+	if(frames == 0)
+	{
+		fprintf(stderr, "no boot frame found\n");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
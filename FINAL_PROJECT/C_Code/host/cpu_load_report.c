@@ -0,0 +1,145 @@
+/*
+ * cpu_load_report.c
+ *
+ *  Prints the CPU load dumped by the ECUs (see cpu_load.h).
+ *
+ *  usage: cpu-load-report [capture-file]
+ *    reads the bytes captured on the link (default stdin), finds every frame by its start byte
+ *    and checksum, and prints the load of the last seconds, their peak and the load per phase
+ *    since the previous dump. The other bytes of the capture (the normal link traffic) are ignored.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cpu_load.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define REPORT_COUNT_S                 (1024.0 / F_CPU)   /* One Timer1 count (F_CPU/1024) */
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+static uint32_t Report_read32(const uint8_t *data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/* Size of the frame starting at data[0] when it is complete and its checksum is right, else 0 */
+static size_t Report_frameSize(const uint8_t *data, size_t length)
+{
+	size_t size, index;
+	uint8_t checksum = 0;
+
+	if(length < 1 + CPULOAD_FRAME_HEADER_SIZE + 1)
+	{
+		return 0;
+	}
+	size = 1 + CPULOAD_FRAME_HEADER_SIZE + (size_t)data[2] + (size_t)data[3] * 8 + 1;
+	if(length < size)
+	{
+		return 0;
+	}
+	for(index = 1 ; index < size - 1 ; index++)
+	{
+		checksum += data[index];
+	}
+	return (checksum == data[size - 1]) ? size : 0;
+}
+
+static void Report_frame(const uint8_t *frame)
+{
+	const uint8_t *history = frame + 1 + CPULOAD_FRAME_HEADER_SIZE;
+	const uint8_t *phase = history + frame[2];
+	unsigned seconds = frame[2], phases = frame[3], index;
+	uint32_t idle, total;
+
+	printf("# ECU %c: peak %u%% over the last %u s\n", frame[1], frame[4], seconds);
+	printf("load per second (%%, oldest first):");
+	for(index = 0 ; index < seconds ; index++)
+	{
+		if(history[index] != CPULOAD_NO_LOAD)
+		{
+			printf(" %u", history[index]);
+		}
+	}
+	printf("\n%-6s %10s %6s\n", "phase", "time (s)", "load");
+
+	for(index = 0 ; index < phases ; index++, phase += 8)
+	{
+		idle = Report_read32(phase);
+		total = Report_read32(phase + 4);
+		if(total == 0)
+		{
+			continue;
+		}
+		printf("%-6u %10.3f %5.1f%%\n", index, total * REPORT_COUNT_S, 100.0 * (double)(total - idle) / (double)total);
+	}
+}
+
+/*******************************************************************************
+ *                                 Main                                        *
+ *******************************************************************************/
+int main(int argc, char **argv)
+{
+	FILE *input = stdin;
+	uint8_t *data = NULL;
+	size_t length = 0, capacity = 0, offset = 0, size;
+	unsigned frames = 0;
+
+	if(argc > 2)
+	{
+		fprintf(stderr, "usage: %s [capture-file]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	if((argc == 2) && ((input = fopen(argv[1], "rb")) == NULL))
+	{
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	for(;;)
+	{
+		if(length == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 4096;
+			if((data = realloc(data, capacity)) == NULL)
+			{
+				perror("realloc");
+				return EXIT_FAILURE;
+			}
+		}
+		size = fread(data + length, 1, capacity - length, input);
+		if(size == 0)
+		{
+			break;
+		}
+		length += size;
+	}
+
+	while(offset < length)
+	{
+		if((data[offset] == CPULOAD_FRAME_START) && ((size = Report_frameSize(data + offset, length - offset)) != 0))
+		{
+			Report_frame(data + offset);
+			offset += size;
+			frames++;
+		}
+		else
+		{
+			offset++;
+		}
+	}
+
+	free(data);
+	if(frames == 0)
+	{
+		fprintf(stderr, "no CPU load frame found\n");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
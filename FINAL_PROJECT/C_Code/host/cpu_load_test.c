@@ -0,0 +1,144 @@
+/*
+ * cpu_load_test.c
+ *
+ *  Checks the load per second of cpu_load.c (built with the Control ecu_config.h): known idle and
+ *  busy spans on a stubbed Timestamp_now(), some of them across the end of a second, then the
+ *  history and the phase sums of the dump frame captured from a stubbed UART_sendByte().
+ *
+ *  usage: cpu-load-test (exit status 0 when every check passes)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cpu_load.h"
+#include "UART.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define TEST_PHASES                    4        /* ECU_PHASES of Control/ecu_config.h */
+#define TEST_FRAME_SIZE                (1 + CPULOAD_FRAME_HEADER_SIZE + CPULOAD_HISTORY + TEST_PHASES * 8 + 1)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint32 g_now = 0;                         /* Timer1 counts returned by the stub */
+static uint8_t g_frame[TEST_FRAME_SIZE];         /* Bytes sent by the dump */
+static size_t g_frameLength = 0;
+static unsigned g_failures = 0;
+
+/*******************************************************************************
+ *                              Stubs                                          *
+ *******************************************************************************/
+
+uint32 Timestamp_now(void)
+{
+	return g_now;
+}
+
+void UART_sendByte(const uint8 data)
+{
+	if(g_frameLength < TEST_FRAME_SIZE)
+	{
+		g_frame[g_frameLength] = data;
+	}
+	g_frameLength++;
+}
+
+uint8 UART_recieveByte(void)
+{
+	return 0;
+}
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+static void Test_busy(uint32 counts)
+{
+	g_now += counts;
+}
+
+static void Test_idle(uint32 counts)
+{
+	CpuLoad_idleBegin();
+	g_now += counts;
+	CpuLoad_idleEnd();
+}
+
+static void Test_check(const char *name, unsigned long value, unsigned long expected)
+{
+	if(value != expected)
+	{
+		printf("FAIL %s: %lu, expected %lu\n", name, value, expected);
+		g_failures++;
+	}
+}
+
+static uint32_t Test_read32(const uint8_t *data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/* Dump and check the history (oldest first) and the sums of phase 0 */
+static void Test_dump(const uint8_t *history, uint32_t idle, uint32_t total)
+{
+	const uint8_t *phase = g_frame + 1 + CPULOAD_FRAME_HEADER_SIZE + CPULOAD_HISTORY;
+	char name[32];
+	size_t index;
+
+	g_frameLength = 0;
+	CpuLoad_dump();
+	Test_check("frame size", g_frameLength, TEST_FRAME_SIZE);
+	Test_check("frame start", g_frame[0], CPULOAD_FRAME_START);
+	Test_check("phase count", g_frame[3], TEST_PHASES);
+	for(index = 0 ; index < CPULOAD_HISTORY ; index++)
+	{
+		sprintf(name, "second %u", (unsigned)index);
+		Test_check(name, g_frame[1 + CPULOAD_FRAME_HEADER_SIZE + index], history[index]);
+	}
+	Test_check("phase 0 idle", Test_read32(phase), idle);
+	Test_check("phase 0 total", Test_read32(phase + 4), total);
+}
+
+/*******************************************************************************
+ *                                Main                                         *
+ *******************************************************************************/
+
+int main(void)
+{
+	const uint32 window = CPULOAD_WINDOW;
+	uint8_t history[CPULOAD_HISTORY];
+
+	CpuLoad_init();
+
+	/* One second 25% busy, the idle span ends right on its end */
+	Test_busy(window / 4);
+	Test_idle(window - window / 4);
+
+	/* An idle span across the end of a second: 50% and 50% */
+	Test_busy(window / 2);
+	Test_idle(window);
+	Test_busy(window / 2);
+
+	/* An idle span of three whole seconds, then a busy second */
+	Test_idle(3 * window);
+	Test_busy(window);
+
+	memset(history, CPULOAD_NO_LOAD, sizeof(history));
+	memcpy(history + CPULOAD_HISTORY - 7, "\x19\x32\x32\x00\x00\x00\x64", 7);
+	Test_dump(history, (window - window / 4) + window + 3 * window, 7 * window);
+
+	/* A second dump: same history, phase sums cleared */
+	Test_dump(history, 0, 0);
+
+	if(g_failures != 0)
+	{
+		printf("cpu-load-test: %u check(s) failed\n", g_failures);
+		return 1;
+	}
+	printf("cpu-load-test: all checks passed\n");
+	return 0;
+}
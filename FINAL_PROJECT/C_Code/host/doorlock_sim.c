@@ -0,0 +1,593 @@
+/*
+ * doorlock_sim.c
+ *
+ *  Full system simulator: runs hmi_host and control_host (next to this executable) as two
+ *  processes, their UARTs connected by a socket pair and their clocks kept together through
+ *  shared memory (see HostHal_SharedClockType), and drives them from a scenario:
+ *  keys for the HMI keypad, PIR and obstacle commands for the door model of the Control ECU,
+ *  waits on what the LCD shows and on the door reaching its end stops.
+ *
+ *  usage: doorlock-sim [-s scale] [-n cycles] [-e eeprom-file] [-v] [scenario-file]
+ *    -s  virtual seconds per real second (default 0 = as fast as the host can run both ECUs)
+ *    -n  unlock/lock cycles of the built-in scenario (default 10)
+ *    -e  EEPROM content file (default: blank EEPROM, nothing kept)
+ *    -v  print the LCD and door events as they come
+ *
+ *  Scenario commands (one per line, '#' starts a comment):
+ *    keys <chars>        type on the keypad ('c' is Enter)
+ *    expect <text>       wait until one of the LCD lines contains the text
+ *    door open|closed    wait until the door reaches that end stop
+ *    pir 0|1             nobody / someone in front of the door
+ *    obstacle <N>|off    block the closing door at encoder position N
+ *    sensors 0|1         encoder, end stop switches and shunt not wired (stock schematic) / wired (default)
+ *    delay <ms>          let the given virtual time pass
+ *    mark                start a latency measurement
+ *    lap <name>          record the virtual time since the last mark under the given name
+ *    repeat <n> ... end  run the enclosed commands n times (no nesting)
+ *
+ *  All times are virtual (the shared clock of the ECUs), so the latencies don't depend on the host speed.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hal_host.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define SIM_DEFAULT_SCALE              0.0
+#define SIM_DEFAULT_CYCLES             10
+#define SIM_TIMEOUT_SECONDS            60.0     /* Virtual, for every wait */
+#define SIM_LCD_COLUMNS                16
+#define SIM_MAX_COMMANDS               256
+#define SIM_MAX_LAPS                   16
+#define SIM_LINE_SIZE                  128
+#define SIM_POLL_MS                    1        /* Real time between two looks at the shared clock */
+
+typedef struct
+{
+	int fd;
+	char buffer[SIM_LINE_SIZE];
+	size_t length;
+} Sim_LineReaderType;
+
+typedef struct
+{
+	char name[32];
+	double *samples;
+	size_t count, capacity;
+} Sim_LapType;
+
+/*******************************************************************************
+ *                           Private Variables                                 *
+ *******************************************************************************/
+static double g_scale = SIM_DEFAULT_SCALE;
+static int g_verbose = 0;
+static HostHal_SharedClockType *g_clock;
+
+static Sim_LineReaderType g_lcdReader, g_plantReader;
+static int g_keypadFd, g_plantFd;
+static pid_t g_hmiPid, g_controlPid;
+
+static char g_lcd[2][SIM_LCD_COLUMNS + 1];
+static char g_door[16] = "closed";
+
+static double g_mark = 0.0;
+static Sim_LapType g_laps[SIM_MAX_LAPS];
+static size_t g_lapCount = 0;
+
+static const char g_defaultScenario[] =
+	"# first boot, set the password\n"
+	"expect PLZ enter pass\n"
+	"keys 12345=\n"
+	"expect Re_enter pass\n"
+	"keys 12345=\n"
+	"expect + : Open Door\n"
+	"repeat %d\n"
+	"keys +\n"
+	"expect PLZ enter pass\n"
+	"keys 12345\n"
+	"mark\n"
+	"keys =\n"
+	"expect Door Unlocking\n"
+	"lap auth\n"
+	"pir 1\n"
+	"door open\n"
+	"lap open\n"
+	"delay 2000\n"
+	"pir 0\n"
+	"mark\n"
+	"door closed\n"
+	"lap clear-to-closed\n"
+	"expect + : Open Door\n"
+	"end\n";
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+/* Virtual seconds since the start, the time both ECUs reached */
+static double Sim_now(void)
+{
+	uint64_t hmi = g_clock->cycles[0], control = g_clock->cycles[1];
+
+	return (double)((hmi < control) ? hmi : control) / F_CPU;
+}
+
+static void Sim_fail(const char *what, const char *argument)
+{
+	fprintf(stderr, "doorlock-sim: %.3f %s %s (LCD |%s|%s|, door %s)\n",
+			Sim_now(), what, argument, g_lcd[0], g_lcd[1], g_door);
+	kill(g_hmiPid, SIGTERM);
+	kill(g_controlPid, SIGTERM);
+	exit(EXIT_FAILURE);
+}
+
+/* "[   1.234] |line one        |line two        |" */
+static void Sim_lcdLine(const char *line)
+{
+	const char *first = strchr(line, '|');
+
+	if((first == NULL) || (strlen(first) < 2 * SIM_LCD_COLUMNS + 3))
+	{
+		return;
+	}
+	memcpy(g_lcd[0], first + 1, SIM_LCD_COLUMNS);
+	memcpy(g_lcd[1], first + 2 + SIM_LCD_COLUMNS, SIM_LCD_COLUMNS);
+	if(g_verbose)
+	{
+		printf("%10.3f lcd  |%s|%s|\n", Sim_now(), g_lcd[0], g_lcd[1]);
+	}
+}
+
+/* "<seconds> door <state>" */
+static void Sim_plantLine(const char *line)
+{
+	double seconds;
+
+	if(sscanf(line, "%lf door %15s", &seconds, g_door) == 2 && g_verbose)
+	{
+		printf("%10.3f door %s\n", Sim_now(), g_door);
+	}
+}
+
+/* Read what is available and hand every complete line over, returns -1 once the writer is gone */
+static int Sim_readLines(Sim_LineReaderType *reader, void (*handler)(const char *))
+{
+	ssize_t count = read(reader->fd, reader->buffer + reader->length, sizeof(reader->buffer) - 1 - reader->length);
+	char *end;
+
+	if(count <= 0)
+	{
+		return ((count < 0) && (errno == EINTR)) ? 0 : -1;
+	}
+	reader->length += (size_t)count;
+	reader->buffer[reader->length] = '\0';
+	while((end = strchr(reader->buffer, '\n')) != NULL)
+	{
+		*end = '\0';
+		handler(reader->buffer);
+		reader->length -= (size_t)(end + 1 - reader->buffer);
+		memmove(reader->buffer, end + 1, reader->length + 1);
+	}
+	if(reader->length == sizeof(reader->buffer) - 1)
+	{
+		reader->length = 0;   /* Line too long, drop it */
+	}
+	return 0;
+}
+
+/* Process the ECU output until the condition holds (or the virtual deadline passed for NULL) */
+static int Sim_waitFor(int (*condition)(const char *), const char *argument, double seconds)
+{
+	double deadline = Sim_now() + seconds;
+	struct pollfd fds[2] = {{g_lcdReader.fd, POLLIN, 0}, {g_plantReader.fd, POLLIN, 0}};
+
+	while(1)
+	{
+		if((condition != NULL) && condition(argument))
+		{
+			return 1;
+		}
+		if(Sim_now() >= deadline)
+		{
+			return condition == NULL;
+		}
+		if(poll(fds, 2, SIM_POLL_MS) <= 0)
+		{
+			continue;
+		}
+		if((fds[0].revents & (POLLIN | POLLHUP)) && (Sim_readLines(&g_lcdReader, Sim_lcdLine) < 0))
+		{
+			Sim_fail("HMI ECU exited while waiting for", argument);
+		}
+		if((fds[1].revents & (POLLIN | POLLHUP)) && (Sim_readLines(&g_plantReader, Sim_plantLine) < 0))
+		{
+			Sim_fail("Control ECU exited while waiting for", argument);
+		}
+	}
+}
+
+static int Sim_lcdShows(const char *text)
+{
+	return (strstr(g_lcd[0], text) != NULL) || (strstr(g_lcd[1], text) != NULL);
+}
+
+static int Sim_doorIs(const char *state)
+{
+	return strcmp(g_door, state) == 0;
+}
+
+static void Sim_send(int fd, const char *text)
+{
+	size_t length = strlen(text);
+
+	if(write(fd, text, length) != (ssize_t)length)
+	{
+		Sim_fail("can't write", text);
+	}
+}
+
+static void Sim_lap(const char *name)
+{
+	size_t index;
+	Sim_LapType *lap = NULL;
+
+	for(index = 0 ; index < g_lapCount ; index++)
+	{
+		if(strcmp(g_laps[index].name, name) == 0)
+		{
+			lap = &g_laps[index];
+		}
+	}
+	if(lap == NULL)
+	{
+		if(g_lapCount == SIM_MAX_LAPS)
+		{
+			return;
+		}
+		lap = &g_laps[g_lapCount++];
+		snprintf(lap->name, sizeof(lap->name), "%s", name);
+	}
+	if(lap->count == lap->capacity)
+	{
+		lap->capacity = lap->capacity ? 2 * lap->capacity : 64;
+		lap->samples = realloc(lap->samples, lap->capacity * sizeof(double));
+		if(lap->samples == NULL)
+		{
+			Sim_fail("out of memory for", name);
+		}
+	}
+	lap->samples[lap->count++] = Sim_now() - g_mark;
+}
+
+static int Sim_compare(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void Sim_report(unsigned long cycles, double realSeconds)
+{
+	size_t index, sample;
+	double sum;
+
+	printf("doorlock-sim: %lu commands run in %.3f virtual s (%.1f real s, x%.1f)\n",
+			cycles, Sim_now(), realSeconds, Sim_now() / realSeconds);
+	printf("%-20s %8s %10s %10s %10s %10s\n", "latency (ms)", "count", "mean", "p50", "p99", "max");
+	for(index = 0 ; index < g_lapCount ; index++)
+	{
+		Sim_LapType *lap = &g_laps[index];
+
+		qsort(lap->samples, lap->count, sizeof(double), Sim_compare);
+		for(sum = 0, sample = 0 ; sample < lap->count ; sample++)
+		{
+			sum += lap->samples[sample];
+		}
+		printf("%-20s %8zu %10.1f %10.1f %10.1f %10.1f\n", lap->name, lap->count,
+				1000.0 * sum / lap->count,
+				1000.0 * lap->samples[lap->count / 2],
+				1000.0 * lap->samples[(lap->count * 99) / 100],
+				1000.0 * lap->samples[lap->count - 1]);
+	}
+}
+
+/* Run one scenario command */
+static void Sim_execute(const char *command, const char *argument)
+{
+	char text[SIM_LINE_SIZE];
+
+	if(g_verbose)
+	{
+		printf("%10.3f run  %s %s\n", Sim_now(), command, argument);
+	}
+	if(strcmp(command, "keys") == 0)
+	{
+		Sim_send(g_keypadFd, argument);
+	}
+	else if(strcmp(command, "expect") == 0)
+	{
+		if(!Sim_waitFor(Sim_lcdShows, argument, SIM_TIMEOUT_SECONDS))
+		{
+			Sim_fail("timeout waiting for LCD", argument);
+		}
+	}
+	else if(strcmp(command, "door") == 0)
+	{
+		if(!Sim_waitFor(Sim_doorIs, argument, SIM_TIMEOUT_SECONDS))
+		{
+			Sim_fail("timeout waiting for door", argument);
+		}
+	}
+	else if((strcmp(command, "pir") == 0) || (strcmp(command, "obstacle") == 0) || (strcmp(command, "sensors") == 0))
+	{
+		snprintf(text, sizeof(text), "%s %s\n", command, argument);
+		Sim_send(g_plantFd, text);
+	}
+	else if(strcmp(command, "delay") == 0)
+	{
+		Sim_waitFor(NULL, argument, atof(argument) / 1000.0);
+	}
+	else if(strcmp(command, "mark") == 0)
+	{
+		g_mark = Sim_now();
+	}
+	else if(strcmp(command, "lap") == 0)
+	{
+		Sim_lap(argument);
+	}
+	else
+	{
+		Sim_fail("unknown command", command);
+	}
+}
+
+/* Split the scenario in lines and run it, returns the number of commands executed */
+static unsigned long Sim_run(char *scenario)
+{
+	char *lines[SIM_MAX_COMMANDS];
+	char *line, *argument, *save = NULL;
+	size_t count = 0, index, loopStart = 0;
+	long loopsLeft = 0;
+	unsigned long executed = 0;
+
+	for(line = strtok_r(scenario, "\n", &save) ; line != NULL ; line = strtok_r(NULL, "\n", &save))
+	{
+		line += strspn(line, " \t");
+		if((*line != '\0') && (*line != '#') && (count < SIM_MAX_COMMANDS))
+		{
+			lines[count++] = line;
+		}
+	}
+
+	for(index = 0 ; index < count ; index++)
+	{
+		char command[16];
+		int skip = 0;
+
+		if(sscanf(lines[index], "%15s%n", command, &skip) != 1)
+		{
+			continue;
+		}
+		argument = lines[index] + skip;
+		argument += strspn(argument, " \t");
+
+		if(strcmp(command, "repeat") == 0)
+		{
+			loopsLeft = atol(argument);
+			loopStart = index;
+			if(loopsLeft <= 0)
+			{
+				while((index < count) && (strncmp(lines[index], "end", 3) != 0))
+				{
+					index++;
+				}
+			}
+		}
+		else if(strcmp(command, "end") == 0)
+		{
+			if(--loopsLeft > 0)
+			{
+				index = loopStart;
+			}
+		}
+		else
+		{
+			Sim_execute(command, argument);
+			executed++;
+		}
+	}
+	return executed;
+}
+
+static char *Sim_readFile(const char *path)
+{
+	FILE *file = fopen(path, "r");
+	char *text;
+	long size;
+
+	if(file == NULL)
+	{
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	rewind(file);
+	text = malloc((size_t)size + 1);
+	if((text == NULL) || (fread(text, 1, (size_t)size, file) != (size_t)size))
+	{
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+	text[size] = '\0';
+	fclose(file);
+	return text;
+}
+
+/* Start an ECU with the given descriptors passed through the environment */
+static pid_t Sim_spawn(const char *directory, const char *program, char *const environment[], const int keep[], int keepCount)
+{
+	char path[PATH_MAX];
+	pid_t pid;
+	int index, fd;
+
+	snprintf(path, sizeof(path), "%s/%s", directory, program);
+	pid = fork();
+	if(pid < 0)
+	{
+		perror("fork");
+		exit(EXIT_FAILURE);
+	}
+	if(pid == 0)
+	{
+		for(index = 0 ; environment[index] != NULL ; index++)
+		{
+			putenv(environment[index]);
+		}
+		/* Close every descriptor the ECU doesn't own */
+		for(fd = 3 ; fd < 64 ; fd++)
+		{
+			int owned = 0;
+
+			for(index = 0 ; index < keepCount ; index++)
+			{
+				owned |= (keep[index] == fd);
+			}
+			if(!owned)
+			{
+				close(fd);
+			}
+		}
+		execl(path, program, (char *)NULL);
+		perror(path);
+		_exit(EXIT_FAILURE);
+	}
+	return pid;
+}
+
+/*******************************************************************************
+ *                                  Main                                       *
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+	char self[PATH_MAX], *directory, *scenario;
+	char scaleEnv[64], clockEnv[32], uartHmiEnv[32], uartControlEnv[32], keypadEnv[32], lcdEnv[32], plantEnv[32], eepromEnv[PATH_MAX + 32];
+	int uart[2], keypad[2], lcd[2], plant[2], clock;
+	int option, cycles = SIM_DEFAULT_CYCLES;
+	const char *eeprom = NULL;
+	ssize_t length;
+	unsigned long executed;
+	struct timespec start, end;
+
+	while((option = getopt(argc, argv, "s:n:e:v")) != -1)
+	{
+		switch(option)
+		{
+		case 's': g_scale = atof(optarg); break;
+		case 'n': cycles = atoi(optarg); break;
+		case 'e': eeprom = optarg; break;
+		case 'v': g_verbose = 1; break;
+		default:
+			fprintf(stderr, "usage: %s [-s scale] [-n cycles] [-e eeprom-file] [-v] [scenario-file]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if(optind < argc)
+	{
+		scenario = Sim_readFile(argv[optind]);
+	}
+	else
+	{
+		scenario = malloc(sizeof(g_defaultScenario) + 16);
+		sprintf(scenario, g_defaultScenario, cycles);
+	}
+
+	length = readlink("/proc/self/exe", self, sizeof(self) - 1);
+	if(length < 0)
+	{
+		perror("/proc/self/exe");
+		return EXIT_FAILURE;
+	}
+	self[length] = '\0';
+	directory = dirname(self);
+
+	/* Shared clock, one slot per ECU (HMI 0, Control 1) */
+	clock = memfd_create("doorlock-clock", 0);
+	if((clock < 0) || (ftruncate(clock, sizeof(HostHal_SharedClockType)) < 0) ||
+	   ((g_clock = mmap(NULL, sizeof(HostHal_SharedClockType), PROT_READ | PROT_WRITE, MAP_SHARED, clock, 0)) == MAP_FAILED))
+	{
+		perror("doorlock-sim: shared clock");
+		return EXIT_FAILURE;
+	}
+
+	if((socketpair(AF_UNIX, SOCK_STREAM, 0, uart) < 0) || (socketpair(AF_UNIX, SOCK_STREAM, 0, plant) < 0) ||
+	   (pipe(keypad) < 0) || (pipe(lcd) < 0))
+	{
+		perror("doorlock-sim");
+		return EXIT_FAILURE;
+	}
+	signal(SIGPIPE, SIG_IGN);
+
+	snprintf(scaleEnv, sizeof(scaleEnv), "DOORLOCK_TIME_SCALE=%g", g_scale);
+	snprintf(clockEnv, sizeof(clockEnv), "DOORLOCK_CLOCK_FD=%d", clock);
+	snprintf(uartHmiEnv, sizeof(uartHmiEnv), "DOORLOCK_UART_FD=%d", uart[0]);
+	snprintf(uartControlEnv, sizeof(uartControlEnv), "DOORLOCK_UART_FD=%d", uart[1]);
+	snprintf(keypadEnv, sizeof(keypadEnv), "DOORLOCK_KEYPAD_FD=%d", keypad[0]);
+	snprintf(lcdEnv, sizeof(lcdEnv), "DOORLOCK_LCD_FD=%d", lcd[1]);
+	snprintf(plantEnv, sizeof(plantEnv), "DOORLOCK_PLANT_FD=%d", plant[1]);
+	snprintf(eepromEnv, sizeof(eepromEnv), "DOORLOCK_EEPROM_FILE=%s", eeprom ? eeprom : "");
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	{
+		char hmiSlot[] = "DOORLOCK_CLOCK_SLOT=0", controlSlot[] = "DOORLOCK_CLOCK_SLOT=1";
+		char *hmiEnvironment[] = {scaleEnv, clockEnv, hmiSlot, uartHmiEnv, keypadEnv, lcdEnv, NULL};
+		char *controlEnvironment[] = {scaleEnv, clockEnv, controlSlot, uartControlEnv, plantEnv, eeprom ? eepromEnv : NULL, NULL};
+		const int hmiFds[] = {clock, uart[0], keypad[0], lcd[1]};
+		const int controlFds[] = {clock, uart[1], plant[1]};
+
+		g_hmiPid = Sim_spawn(directory, "hmi_host", hmiEnvironment, hmiFds, 4);
+		g_controlPid = Sim_spawn(directory, "control_host", controlEnvironment, controlFds, 3);
+	}
+	close(uart[0]);
+	close(uart[1]);
+	close(keypad[0]);
+	close(lcd[1]);
+	close(plant[1]);
+
+	g_keypadFd = keypad[1];
+	g_plantFd = plant[0];
+	g_lcdReader.fd = lcd[0];
+	g_plantReader.fd = plant[0];
+	memset(g_lcd, ' ', sizeof(g_lcd));
+	g_lcd[0][SIM_LCD_COLUMNS] = g_lcd[1][SIM_LCD_COLUMNS] = '\0';
+
+	executed = Sim_run(scenario);
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	Sim_report(executed, (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+
+	kill(g_hmiPid, SIGTERM);
+	kill(g_controlPid, SIGTERM);
+	waitpid(g_hmiPid, NULL, 0);
+	waitpid(g_controlPid, NULL, 0);
+	free(scenario);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,691 @@
+/*
+ * hal_host.c
+ *
+ *  Host backend of the hardware layer: register storage, virtual clock and peripheral models
+ *  (Timer0/1/2, ADC, external interrupts, port pins) plus the ISR dispatch.
+ *
+ *  Threads: the application runs on the main thread as on the AVR, the model thread advances
+ *  the clock and calls the ISRs. An ISR only runs while the SREG I bit is set and nobody holds
+ *  the interrupt lock (cli()/sei() and ATOMIC_BLOCK take it), so the application sees the same
+ *  atomicity as on the chip.
+ *
+ *  Limits of the models:
+ *  - Interrupt flags are kept inside the model, writing a one to TIFR/GIFR (or ADIF in ADCSRA)
+ *    clears them as on the chip, but reading those registers doesn't show the pending flags.
+ *  - Timers run from the CPU clock only (no external clock, no asynchronous Timer2),
+ *    phase correct PWM counts like fast PWM and no output compare pin is driven.
+ *  - The ADC is only triggered by ADSC (single or free running mode).
+ */
+
+#include <avr/io.h>
+#include "hal_host.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+
+/*******************************************************************************
+ *                                Registers                                    *
+ *******************************************************************************/
+#define HOST_IO_DEFINE8(NAME)          volatile uint8_t NAME;
+#define HOST_IO_DEFINE16(NAME)         volatile uint16_t NAME;
+HOST_IO_REGISTERS(HOST_IO_DEFINE8, HOST_IO_DEFINE16)
+
+/*******************************************************************************
+ *                                Vectors                                      *
+ *******************************************************************************/
+#define HOST_NUM_OF_VECTORS            21
+
+/* An application only defines the ISRs it uses, the others stay NULL */
+#define HOST_WEAK_VECTOR(N)            extern void __vector_##N(void) __attribute__((weak));
+HOST_WEAK_VECTOR(1)  HOST_WEAK_VECTOR(2)  HOST_WEAK_VECTOR(3)  HOST_WEAK_VECTOR(4)
+HOST_WEAK_VECTOR(5)  HOST_WEAK_VECTOR(6)  HOST_WEAK_VECTOR(7)  HOST_WEAK_VECTOR(8)
+HOST_WEAK_VECTOR(9)  HOST_WEAK_VECTOR(10) HOST_WEAK_VECTOR(11) HOST_WEAK_VECTOR(12)
+HOST_WEAK_VECTOR(13) HOST_WEAK_VECTOR(14) HOST_WEAK_VECTOR(15) HOST_WEAK_VECTOR(16)
+HOST_WEAK_VECTOR(17) HOST_WEAK_VECTOR(18) HOST_WEAK_VECTOR(19) HOST_WEAK_VECTOR(20)
+
+static void (*const g_vectors[HOST_NUM_OF_VECTORS])(void) =
+{
+	NULL,        __vector_1,  __vector_2,  __vector_3,  __vector_4,  __vector_5,  __vector_6,
+	__vector_7,  __vector_8,  __vector_9,  __vector_10, __vector_11, __vector_12, __vector_13,
+	__vector_14, __vector_15, __vector_16, __vector_17, __vector_18, __vector_19, __vector_20
+};
+
+/* Vector numbers (priority order, the lowest runs first) */
+#define HOST_VECT_INT0                 1
+#define HOST_VECT_INT1                 2
+#define HOST_VECT_INT2                 3
+#define HOST_VECT_TIMER2_COMP          4
+#define HOST_VECT_TIMER2_OVF           5
+#define HOST_VECT_TIMER1_CAPT          6
+#define HOST_VECT_TIMER1_COMPA         7
+#define HOST_VECT_TIMER1_COMPB         8
+#define HOST_VECT_TIMER1_OVF           9
+#define HOST_VECT_TIMER0_COMP          10
+#define HOST_VECT_TIMER0_OVF           11
+#define HOST_VECT_ADC                  16
+
+/* TIFR/TIMSK bit of every timer vector, same position in both registers */
+static const uint8_t g_timerVectorBit[HOST_NUM_OF_VECTORS] =
+{
+	[HOST_VECT_TIMER2_COMP] = OCF2,   [HOST_VECT_TIMER2_OVF] = TOV2,
+	[HOST_VECT_TIMER1_CAPT] = ICF1,   [HOST_VECT_TIMER1_COMPA] = OCF1A,
+	[HOST_VECT_TIMER1_COMPB] = OCF1B, [HOST_VECT_TIMER1_OVF] = TOV1,
+	[HOST_VECT_TIMER0_COMP] = OCF0,   [HOST_VECT_TIMER0_OVF] = TOV0
+};
+
+/*******************************************************************************
+ *                           Private Variables                                 *
+ *******************************************************************************/
+
+/* Interrupt lock (recursive, an ISR may use ATOMIC_BLOCK too) */
+static pthread_mutex_t g_irqLock;
+
+/* Clock waiters (delays and sleep) */
+static pthread_mutex_t g_clockLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_clockCond = PTHREAD_COND_INITIALIZER;
+static volatile uint64_t g_cycles = 0;
+static uint64_t g_wakeAt = UINT64_MAX;   /* Earliest cycle a delay waits for */
+static uint64_t g_isrCount = 0;
+static uint8_t g_sleepers = 0;
+
+static __thread uint8_t t_isModelThread = 0;
+static double g_timeScale = 1.0;
+static HostHal_SharedClockType *g_sharedClock = NULL;
+static uint8_t g_clockSlot = 0;
+static void (*volatile g_frameHook)(void) = NULL;
+static void (*volatile g_stepHook)(void) = NULL;
+
+/* Interrupt flags raised by the models, bit n = vector n */
+static volatile uint32_t g_pending = 0;
+
+/* Timer prescaler remainders (CPU cycles not counted yet) */
+static uint16_t g_timer0Cycles, g_timer1Cycles, g_timer2Cycles;
+
+/* ADC state */
+static uint16_t g_analog[HOST_HAL_ADC_CHANNELS];
+static uint8_t g_adcBusy = 0, g_adcFirst = 1;
+static uint32_t g_adcCycles;
+
+/* External drive of the port pins */
+static volatile uint8_t *const g_ddrReg[4] = {&DDRA, &DDRB, &DDRC, &DDRD};
+static volatile uint8_t *const g_portReg[4] = {&PORTA, &PORTB, &PORTC, &PORTD};
+static volatile uint8_t *const g_pinReg[4] = {&PINA, &PINB, &PINC, &PIND};
+static uint8_t g_driveMask[4], g_driveLevel[4];
+static pthread_mutex_t g_pinLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Last level of the INT0 (PD2), INT1 (PD3) and INT2 (PB2) pins */
+static uint8_t g_intLevel[3] = {1, 1, 1};
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+static void HostHal_raise(uint8_t vector)
+{
+	__atomic_fetch_or(&g_pending, (uint32_t)1 << vector, __ATOMIC_SEQ_CST);
+}
+
+static void HostHal_clear(uint32_t mask)
+{
+	__atomic_fetch_and(&g_pending, ~mask, __ATOMIC_SEQ_CST);
+}
+
+/* Writing a one to an interrupt flag clears it */
+static void HostHal_clearWrittenFlags(void)
+{
+	uint8_t vector;
+	uint8_t tifr = TIFR;
+	uint8_t gifr = GIFR;
+
+	if(tifr)
+	{
+		TIFR = 0;
+		for(vector = HOST_VECT_TIMER2_COMP ; vector <= HOST_VECT_TIMER0_OVF ; vector++)
+		{
+			if(tifr & (1 << g_timerVectorBit[vector]))
+			{
+				HostHal_clear((uint32_t)1 << vector);
+			}
+		}
+	}
+	if(gifr)
+	{
+		GIFR = 0;
+		if(gifr & (1 << INTF0)) HostHal_clear((uint32_t)1 << HOST_VECT_INT0);
+		if(gifr & (1 << INTF1)) HostHal_clear((uint32_t)1 << HOST_VECT_INT1);
+		if(gifr & (1 << INTF2)) HostHal_clear((uint32_t)1 << HOST_VECT_INT2);
+	}
+	if(ADCSRA & (1 << ADIF))
+	{
+		ADCSRA &= ~(1 << ADIF);
+		HostHal_clear((uint32_t)1 << HOST_VECT_ADC);
+	}
+}
+
+/*
+ * One count of an 8-bit timer: normal, CTC (TOP = OCR) or PWM (TOP = 0xFF) mode
+ */
+static void HostHal_count8(volatile uint8_t *tcnt, uint8_t ocr, uint8_t ctc, uint8_t compVector, uint8_t ovfVector)
+{
+	uint8_t count = *tcnt;
+
+	if(ctc && (count == ocr))
+	{
+		count = 0;
+	}
+	else
+	{
+		count++;
+		if(count == 0)
+		{
+			HostHal_raise(ovfVector);
+		}
+	}
+	*tcnt = count;
+	if(count == ocr)
+	{
+		HostHal_raise(compVector);
+	}
+}
+
+static void HostHal_timer0(void)
+{
+	static const uint16_t prescaler[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+	uint16_t divider = prescaler[TCCR0 & 0x07];
+	uint8_t ctc = (TCCR0 & ((1 << WGM01) | (1 << WGM00))) == (1 << WGM01);
+
+	if(divider == 0)
+	{
+		return;
+	}
+	for(g_timer0Cycles += HOST_HAL_STEP_CYCLES ; g_timer0Cycles >= divider ; g_timer0Cycles -= divider)
+	{
+		HostHal_count8(&TCNT0, OCR0, ctc, HOST_VECT_TIMER0_COMP, HOST_VECT_TIMER0_OVF);
+	}
+}
+
+static void HostHal_timer2(void)
+{
+	static const uint16_t prescaler[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+	uint16_t divider = prescaler[TCCR2 & 0x07];
+	uint8_t ctc = (TCCR2 & ((1 << WGM21) | (1 << WGM20))) == (1 << WGM21);
+
+	if(divider == 0)
+	{
+		return;
+	}
+	for(g_timer2Cycles += HOST_HAL_STEP_CYCLES ; g_timer2Cycles >= divider ; g_timer2Cycles -= divider)
+	{
+		HostHal_count8(&TCNT2, OCR2, ctc, HOST_VECT_TIMER2_COMP, HOST_VECT_TIMER2_OVF);
+	}
+}
+
+static void HostHal_timer1(void)
+{
+	static const uint16_t prescaler[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+	uint16_t divider = prescaler[TCCR1B & 0x07];
+	uint8_t mode = ((TCCR1B >> WGM12) & 0x03) << 2 | (TCCR1A & 0x03);
+	uint16_t top, count;
+	uint8_t ctc = (mode == 4) || (mode == 12);
+
+	if(divider == 0)
+	{
+		return;
+	}
+	switch(mode)
+	{
+	case 4: case 9: case 11: case 15: top = OCR1A; break;
+	case 8: case 10: case 12: case 14: top = ICR1; break;
+	case 1: case 5: top = 0x00FF; break;
+	case 2: case 6: top = 0x01FF; break;
+	case 3: case 7: top = 0x03FF; break;
+	default: top = 0xFFFF; break;
+	}
+	for(g_timer1Cycles += HOST_HAL_STEP_CYCLES ; g_timer1Cycles >= divider ; g_timer1Cycles -= divider)
+	{
+		count = TCNT1;
+		if(count == top)
+		{
+			count = 0;
+			if(!ctc || (top == 0xFFFF))
+			{
+				HostHal_raise(HOST_VECT_TIMER1_OVF);
+			}
+		}
+		else
+		{
+			count++;
+		}
+		TCNT1 = count;
+		if(count == OCR1A)
+		{
+			HostHal_raise(HOST_VECT_TIMER1_COMPA);
+		}
+		if(count == OCR1B)
+		{
+			HostHal_raise(HOST_VECT_TIMER1_COMPB);
+		}
+		if(ctc && (mode == 12) && (count == top))
+		{
+			HostHal_raise(HOST_VECT_TIMER1_CAPT);
+		}
+	}
+}
+
+static void HostHal_adc(void)
+{
+	static const uint8_t prescaler[8] = {2, 2, 4, 8, 16, 32, 64, 128};
+	uint16_t result;
+	uint32_t conversion = 13UL * prescaler[ADCSRA & 0x07];
+
+	if(!(ADCSRA & (1 << ADEN)))
+	{
+		g_adcBusy = 0;
+		g_adcFirst = 1;
+		return;
+	}
+	if(!g_adcBusy)
+	{
+		if(!(ADCSRA & (1 << ADSC)))
+		{
+			return;
+		}
+		/* The first conversion after enabling takes 25 ADC clocks instead of 13 */
+		g_adcBusy = 1;
+		g_adcCycles = g_adcFirst ? (25UL * prescaler[ADCSRA & 0x07]) : conversion;
+		g_adcFirst = 0;
+	}
+
+	if(g_adcCycles > HOST_HAL_STEP_CYCLES)
+	{
+		g_adcCycles -= HOST_HAL_STEP_CYCLES;
+		return;
+	}
+
+	result = g_analog[ADMUX & (HOST_HAL_ADC_CHANNELS - 1)] & 0x03FF;
+	ADC = (ADMUX & (1 << ADLAR)) ? (uint16_t)(result << 6) : result;
+	HostHal_raise(HOST_VECT_ADC);
+
+	/* Free running mode (auto trigger with ADTS = 0) starts the next conversion right away */
+	if((ADCSRA & (1 << ADATE)) && ((SFIOR >> ADTS0) & 0x07) == 0)
+	{
+		g_adcCycles += conversion - HOST_HAL_STEP_CYCLES;
+	}
+	else
+	{
+		ADCSRA &= ~(1 << ADSC);
+		g_adcBusy = 0;
+	}
+}
+
+/*
+ * Recompute the PIN registers and check the external interrupt pins for their configured event
+ * (called with g_pinLock held)
+ */
+static void HostHal_updatePins(void)
+{
+	uint8_t port, level, sense;
+	uint8_t pullUps = (SFIOR & (1 << PUD)) ? 0x00 : 0xFF;
+	static const uint8_t intPort[3] = {3, 3, 1}, intPin[3] = {2, 3, 2};
+	static const uint8_t intVector[3] = {HOST_VECT_INT0, HOST_VECT_INT1, HOST_VECT_INT2};
+
+	for(port = 0 ; port < 4 ; port++)
+	{
+		uint8_t ddr = *g_ddrReg[port], out = *g_portReg[port];
+		uint8_t external = (g_driveMask[port] & g_driveLevel[port]) | (~g_driveMask[port] & out & pullUps);
+		*g_pinReg[port] = (ddr & out) | (~ddr & external);
+	}
+
+	for(port = 0 ; port < 3 ; port++)
+	{
+		level = (*g_pinReg[intPort[port]] >> intPin[port]) & 1;
+		if(port == 2)
+		{
+			sense = (MCUCSR & (1 << ISC2)) ? 3 : 2;      /* INT2 is edge only */
+		}
+		else
+		{
+			sense = (MCUCR >> (port * 2)) & 0x03;
+		}
+
+		if(((sense == 0) && !level) ||
+		   ((sense == 1) && (level != g_intLevel[port])) ||
+		   ((sense == 2) && !level && g_intLevel[port]) ||
+		   ((sense == 3) && level && !g_intLevel[port]))
+		{
+			HostHal_raise(intVector[port]);
+		}
+		g_intLevel[port] = level;
+	}
+}
+
+/* Enable bit of a vector */
+static uint8_t HostHal_isEnabled(uint8_t vector)
+{
+	switch(vector)
+	{
+	case HOST_VECT_INT0: return (GICR >> INT0) & 1;
+	case HOST_VECT_INT1: return (GICR >> INT1) & 1;
+	case HOST_VECT_INT2: return (GICR >> INT2) & 1;
+	case HOST_VECT_ADC:  return (ADCSRA >> ADIE) & 1;
+	default:
+		if((vector >= HOST_VECT_TIMER2_COMP) && (vector <= HOST_VECT_TIMER0_OVF))
+		{
+			return (TIMSK >> g_timerVectorBit[vector]) & 1;
+		}
+		return 0;
+	}
+}
+
+/*
+ * Run the pending ISRs by priority, skipped while the application holds the interrupt lock
+ * (the flags stay pending like on the chip while the I bit is cleared)
+ */
+static void HostHal_dispatch(void)
+{
+	uint8_t vector, ran = 0;
+	uint32_t pending;
+
+	if(pthread_mutex_trylock(&g_irqLock) != 0)
+	{
+		return;
+	}
+	while(SREG & (1 << SREG_I))
+	{
+		pending = g_pending;
+		for(vector = 1 ; vector < HOST_NUM_OF_VECTORS ; vector++)
+		{
+			if((pending & ((uint32_t)1 << vector)) && HostHal_isEnabled(vector))
+			{
+				break;
+			}
+		}
+		if(vector == HOST_NUM_OF_VECTORS)
+		{
+			break;
+		}
+
+		/* The hardware clears the flag when the vector is taken, a vector without an ISR is ignored */
+		HostHal_clear((uint32_t)1 << vector);
+		if(g_vectors[vector] != NULL)
+		{
+			g_vectors[vector]();
+			ran = 1;
+		}
+	}
+	pthread_mutex_unlock(&g_irqLock);
+
+	if(ran)
+	{
+		pthread_mutex_lock(&g_clockLock);
+		g_isrCount++;
+		if(g_sleepers)
+		{
+			pthread_cond_broadcast(&g_clockCond);
+		}
+		pthread_mutex_unlock(&g_clockLock);
+	}
+}
+
+/* Hold the virtual clock back to the scaled real clock (checked once per frame) */
+static void HostHal_pace(const struct timespec *start)
+{
+	struct timespec now, pause;
+	double virtualSeconds, realSeconds;
+
+	if(g_timeScale <= 0.0)
+	{
+		return;
+	}
+	virtualSeconds = (double)g_cycles / F_CPU / g_timeScale;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	realSeconds = (double)(now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+	if(virtualSeconds > realSeconds + 0.001)
+	{
+		pause.tv_sec = (time_t)(virtualSeconds - realSeconds);
+		pause.tv_nsec = (long)((virtualSeconds - realSeconds - pause.tv_sec) * 1e9);
+		nanosleep(&pause, NULL);
+	}
+}
+
+/* Publish the clock and hold it back while another ECU of the simulation is more than the window behind */
+static void HostHal_syncClock(void)
+{
+	uint8_t slot;
+
+	g_sharedClock->cycles[g_clockSlot] = g_cycles;
+	for(slot = 0 ; slot < HOST_HAL_CLOCK_SLOTS ; slot++)
+	{
+		while((slot != g_clockSlot) && (g_sharedClock->cycles[slot] + HOST_HAL_CLOCK_WINDOW < g_cycles))
+		{
+			sched_yield();
+		}
+	}
+}
+
+static void *HostHal_model(void *arg)
+{
+	struct timespec start;
+	uint64_t nextFrame = HOST_HAL_FRAME_US * (F_CPU / 1000000UL);
+	(void)arg;
+
+	t_isModelThread = 1;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	while(1)
+	{
+		HostHal_clearWrittenFlags();
+		pthread_mutex_lock(&g_pinLock);
+		HostHal_updatePins();
+		pthread_mutex_unlock(&g_pinLock);
+		HostHal_timer0();
+		HostHal_timer1();
+		HostHal_timer2();
+		HostHal_adc();
+		g_cycles += HOST_HAL_STEP_CYCLES;
+
+		if(g_stepHook != NULL)
+		{
+			g_stepHook();
+		}
+		HostHal_dispatch();
+
+		if(g_cycles >= g_wakeAt)
+		{
+			pthread_mutex_lock(&g_clockLock);
+			g_wakeAt = UINT64_MAX;
+			pthread_cond_broadcast(&g_clockCond);
+			pthread_mutex_unlock(&g_clockLock);
+		}
+
+		if((g_sharedClock != NULL) && ((g_cycles % HOST_HAL_CLOCK_WINDOW) == 0))
+		{
+			HostHal_syncClock();
+		}
+
+		if(g_cycles >= nextFrame)
+		{
+			nextFrame += HOST_HAL_FRAME_US * (F_CPU / 1000000UL);
+			if(g_frameHook != NULL)
+			{
+				g_frameHook();
+			}
+			HostHal_pace(&start);
+		}
+	}
+	return NULL;
+}
+
+/* Reset: registers at their reset values and the model started before main() */
+__attribute__((constructor)) static void HostHal_reset(void)
+{
+	pthread_mutexattr_t attributes;
+	pthread_t thread;
+	const char *scale = getenv("DOORLOCK_TIME_SCALE");
+	const char *clock = getenv("DOORLOCK_CLOCK_FD");
+	const char *slot = getenv("DOORLOCK_CLOCK_SLOT");
+
+	pthread_mutexattr_init(&attributes);
+	pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&g_irqLock, &attributes);
+	pthread_mutexattr_destroy(&attributes);
+
+	if(scale != NULL)
+	{
+		g_timeScale = atof(scale);
+	}
+	if((clock != NULL) && (slot != NULL))
+	{
+		g_sharedClock = mmap(NULL, sizeof(HostHal_SharedClockType), PROT_READ | PROT_WRITE, MAP_SHARED, atoi(clock), 0);
+		g_clockSlot = (uint8_t)atoi(slot);
+		if((g_sharedClock == MAP_FAILED) || (g_clockSlot >= HOST_HAL_CLOCK_SLOTS))
+		{
+			perror("hal_host: shared clock");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	SPL = RAMEND & 0xFF;
+	SPH = RAMEND >> 8;
+	UCSRA = (1 << UDRE);
+	UCSRC = (1 << UCSZ1) | (1 << UCSZ0);
+
+	if(pthread_create(&thread, NULL, HostHal_model, NULL) != 0)
+	{
+		perror("hal_host: model thread");
+		exit(EXIT_FAILURE);
+	}
+	pthread_detach(thread);
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint64_t HostHal_cycles(void)
+{
+	return g_cycles;
+}
+
+void HostHal_delayCycles(uint64_t cycles)
+{
+	uint64_t target;
+
+	if(t_isModelThread)
+	{
+		return;
+	}
+	pthread_mutex_lock(&g_clockLock);
+	target = g_cycles + cycles;
+	while(g_cycles < target)
+	{
+		if(target < g_wakeAt)
+		{
+			g_wakeAt = target;
+		}
+		pthread_cond_wait(&g_clockCond, &g_clockLock);
+	}
+	pthread_mutex_unlock(&g_clockLock);
+}
+
+void HostHal_sleep(void)
+{
+	uint64_t count;
+
+	if(t_isModelThread)
+	{
+		return;
+	}
+	pthread_mutex_lock(&g_clockLock);
+	count = g_isrCount;
+	g_sleepers++;
+	while(g_isrCount == count)
+	{
+		pthread_cond_wait(&g_clockCond, &g_clockLock);
+	}
+	g_sleepers--;
+	pthread_mutex_unlock(&g_clockLock);
+}
+
+uint8_t HostHal_irqAcquire(uint8_t forceOn)
+{
+	pthread_mutex_lock(&g_irqLock);
+	return forceOn;
+}
+
+void HostHal_irqRelease(const uint8_t *forceOn)
+{
+	if(*forceOn)
+	{
+		SREG |= (1 << SREG_I);
+	}
+	pthread_mutex_unlock(&g_irqLock);
+}
+
+void HostHal_setInterruptFlag(uint8_t enable)
+{
+	pthread_mutex_lock(&g_irqLock);
+	if(enable)
+	{
+		SREG |= (1 << SREG_I);
+	}
+	else
+	{
+		SREG &= ~(1 << SREG_I);
+	}
+	pthread_mutex_unlock(&g_irqLock);
+}
+
+void HostHal_setPin(uint8_t port, uint8_t pin, uint8_t level)
+{
+	pthread_mutex_lock(&g_pinLock);
+	g_driveMask[port] |= (1 << pin);
+	if(level)
+	{
+		g_driveLevel[port] |= (1 << pin);
+	}
+	else
+	{
+		g_driveLevel[port] &= ~(1 << pin);
+	}
+	HostHal_updatePins();
+	pthread_mutex_unlock(&g_pinLock);
+}
+
+void HostHal_releasePin(uint8_t port, uint8_t pin)
+{
+	pthread_mutex_lock(&g_pinLock);
+	g_driveMask[port] &= ~(1 << pin);
+	HostHal_updatePins();
+	pthread_mutex_unlock(&g_pinLock);
+}
+
+uint8_t HostHal_getPin(uint8_t port, uint8_t pin)
+{
+	uint8_t ddr = *g_ddrReg[port], out = *g_portReg[port];
+
+	if(ddr & (1 << pin))
+	{
+		return (out >> pin) & 1;
+	}
+	return (*g_pinReg[port] >> pin) & 1;
+}
+
+void HostHal_setAnalog(uint8_t channel, uint16_t value)
+{
+	g_analog[channel & (HOST_HAL_ADC_CHANNELS - 1)] = value;
+}
+
+void HostHal_setFrameHook(void (*hook)(void))
+{
+	g_frameHook = hook;
+}
+
+void HostHal_setStepHook(void (*hook)(void))
+{
+	g_stepHook = hook;
+}
@@ -0,0 +1,111 @@
+/*
+ * hal_host.h
+ *
+ *  Host backend of the hardware layer, lets an ECU application build and run on Linux.
+ *
+ *  The ATmega32 registers are plain variables (see include/avr/io.h). A model thread started
+ *  before main() advances a virtual clock in steps of HOST_HAL_STEP_CYCLES and, on every step,
+ *  runs the timer/counter, ADC and external interrupt models on those registers, then calls the
+ *  ISRs the application defined, in vector priority order, while the SREG I bit is set.
+ *  The UART, I2C, LCD and keypad drivers are replaced at their API level (UART_host.c,
+ *  I2C_host.c, LCD_host.c, keypad_host.c), so is the stack monitor (stack_monitor_host.c, no RAM
+ *  to paint), the other drivers are built unchanged.
+ *
+ *  Environment:
+ *  DOORLOCK_TIME_SCALE : virtual seconds per real second (default 1, 0 = as fast as possible).
+ *  DOORLOCK_CLOCK_FD   : shared memory holding a HostHal_SharedClockType (set by doorlock-sim),
+ *  DOORLOCK_CLOCK_SLOT   this ECU publishes its clock in the given slot and never runs more than
+ *                        HOST_HAL_CLOCK_WINDOW cycles ahead of the other slots, so the ECUs of a
+ *                        simulation share one virtual time whatever their speed.
+ */
+
+#ifndef HAL_HOST_H_
+#define HAL_HOST_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define HOST_HAL_STEP_CYCLES           200      /* 25us of 8MHz CPU time per model step */
+#define HOST_HAL_FRAME_US              20000UL  /* Period of the frame hook (virtual time) */
+#define HOST_HAL_ADC_CHANNELS          8
+#define HOST_HAL_CLOCK_SLOTS           2
+#define HOST_HAL_CLOCK_WINDOW          (F_CPU / 1000)  /* 1ms */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	volatile uint64_t cycles[HOST_HAL_CLOCK_SLOTS];   /* Virtual clock of every ECU */
+} HostHal_SharedClockType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * CPU cycles elapsed since reset (virtual time).
+ */
+uint64_t HostHal_cycles(void);
+
+/*
+ * Description :
+ * Wait until the virtual clock advanced by the given number of CPU cycles (used by _delay_ms/_delay_us).
+ * Returns right away when called from an ISR, the clock can't move while an ISR runs.
+ */
+void HostHal_delayCycles(uint64_t cycles);
+
+/*
+ * Description :
+ * Wait until the next ISR has run (used by sleep_cpu()).
+ */
+void HostHal_sleep(void);
+
+/*
+ * Description :
+ * Interrupt lock used by cli(), sei() and ATOMIC_BLOCK(), no ISR runs while it is held.
+ * HostHal_irqAcquire returns its argument so it can be kept by the cleanup variable of ATOMIC_BLOCK.
+ */
+uint8_t HostHal_irqAcquire(uint8_t forceOn);
+void HostHal_irqRelease(const uint8_t *forceOn);
+void HostHal_setInterruptFlag(uint8_t enable);
+
+/*
+ * Description :
+ * Drive an input pin from outside the chip (level = 0/1), or release it again
+ * (the pin then reads its pull-up, or 0 without one).
+ * Edges on PD2, PD3 and PB2 raise INT0, INT1 and INT2 as configured in MCUCR/MCUCSR.
+ */
+void HostHal_setPin(uint8_t port, uint8_t pin, uint8_t level);
+void HostHal_releasePin(uint8_t port, uint8_t pin);
+
+/*
+ * Description :
+ * Level seen on a pin (what the chip drives, or else the external level).
+ */
+uint8_t HostHal_getPin(uint8_t port, uint8_t pin);
+
+/*
+ * Description :
+ * Set the 10-bit result the ADC gives for a channel.
+ */
+void HostHal_setAnalog(uint8_t channel, uint16_t value);
+
+/*
+ * Description :
+ * Register a function called from the model thread every HOST_HAL_FRAME_US of virtual time
+ * (outside the interrupt lock), used by the host drivers to refresh their output.
+ */
+void HostHal_setFrameHook(void (*hook)(void));
+
+/*
+ * Description :
+ * Register a function called from the model thread on every step (HOST_HAL_STEP_CYCLES),
+ * before the ISRs of that step run. Used by the models of what is wired to the pins.
+ */
+void HostHal_setStepHook(void (*hook)(void));
+
+#endif /* HAL_HOST_H_ */
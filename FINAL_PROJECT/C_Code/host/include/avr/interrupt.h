@@ -0,0 +1,19 @@
+/*
+ * interrupt.h
+ *
+ *  Host stand-in for <avr/interrupt.h>, an ISR is a normal function called by the model thread of hal_host.c.
+ */
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+#include "hal_host.h"
+
+#define ISR(vector, ...)               void vector(void); void vector(void)
+#define EMPTY_INTERRUPT(vector)        void vector(void); void vector(void) {}
+#define sei()                          HostHal_setInterruptFlag(1)
+#define cli()                          HostHal_setInterruptFlag(0)
+#define reti()                         return
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
@@ -0,0 +1,250 @@
+/*
+ * io.h
+ *
+ *  Host stand-in for <avr/io.h> (ATmega32).
+ *  Every I/O register is a plain variable owned by hal_host.c, the peripheral models
+ *  in that file read the configuration registers and update the status ones.
+ */
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *                                Registers                                    *
+ *******************************************************************************/
+
+/* List of the registers, expanded once here as declarations and once in hal_host.c as definitions */
+#define HOST_IO_REGISTERS(REG8, REG16)                                           \
+	REG8(PINA)  REG8(DDRA)  REG8(PORTA)                                          \
+	REG8(PINB)  REG8(DDRB)  REG8(PORTB)                                          \
+	REG8(PINC)  REG8(DDRC)  REG8(PORTC)                                          \
+	REG8(PIND)  REG8(DDRD)  REG8(PORTD)                                          \
+	REG8(SREG)  REG8(SPL)   REG8(SPH)    REG8(MCUCR)  REG8(MCUCSR) REG8(SFIOR)   \
+	REG8(GICR)  REG8(GIFR)  REG8(TIMSK)  REG8(TIFR)                              \
+	REG8(TCCR0) REG8(TCNT0) REG8(OCR0)                                           \
+	REG8(TCCR1A) REG8(TCCR1B) REG16(TCNT1) REG16(OCR1A) REG16(OCR1B) REG16(ICR1) \
+	REG8(TCCR2) REG8(TCNT2) REG8(OCR2)  REG8(ASSR)                               \
+	REG8(ADMUX) REG8(ADCSRA) REG16(ADC)                                          \
+	REG8(UDR)   REG8(UCSRA) REG8(UCSRB) REG8(UCSRC) REG8(UBRRL) REG8(UBRRH)      \
+	REG8(TWBR)  REG8(TWSR)  REG8(TWAR)  REG8(TWDR)  REG8(TWCR)                   \
+	REG8(SPCR)  REG8(SPSR)  REG8(SPDR)                                           \
+	REG8(EEARL) REG8(EEARH) REG8(EEDR)  REG8(EECR)  REG8(WDTCR)
+
+#define HOST_IO_DECLARE8(NAME)         extern volatile uint8_t NAME;
+#define HOST_IO_DECLARE16(NAME)        extern volatile uint16_t NAME;
+HOST_IO_REGISTERS(HOST_IO_DECLARE8, HOST_IO_DECLARE16)
+
+/* 8-bit halves of the ADC data register (little endian host, as on the AVR) */
+#define ADCL                           (((volatile uint8_t *)&ADC)[0])
+#define ADCH                           (((volatile uint8_t *)&ADC)[1])
+#define ADCW                           ADC
+
+/*******************************************************************************
+ *                                Bit names                                    *
+ *******************************************************************************/
+
+/* Port pins */
+#define PA0 0
+#define PA1 1
+#define PA2 2
+#define PA3 3
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define PA7 7
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PC7 7
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+
+/* SREG */
+#define SREG_I  7
+
+/* MCUCR / MCUCSR / SFIOR */
+#define SE      7
+#define SM2     6
+#define SM1     5
+#define SM0     4
+#define ISC11   3
+#define ISC10   2
+#define ISC01   1
+#define ISC00   0
+#define ISC2    6
+#define ADTS2   7
+#define ADTS1   6
+#define ADTS0   5
+#define PUD     2
+
+/* GICR / GIFR */
+#define INT1    7
+#define INT0    6
+#define INT2    5
+#define IVSEL   1
+#define IVCE    0
+#define INTF1   7
+#define INTF0   6
+#define INTF2   5
+
+/* TIMSK / TIFR */
+#define OCIE2   7
+#define TOIE2   6
+#define TICIE1  5
+#define OCIE1A  4
+#define OCIE1B  3
+#define TOIE1   2
+#define OCIE0   1
+#define TOIE0   0
+#define OCF2    7
+#define TOV2    6
+#define ICF1    5
+#define OCF1A   4
+#define OCF1B   3
+#define TOV1    2
+#define OCF0    1
+#define TOV0    0
+
+/* TCCR0 */
+#define FOC0    7
+#define WGM00   6
+#define COM01   5
+#define COM00   4
+#define WGM01   3
+#define CS02    2
+#define CS01    1
+#define CS00    0
+
+/* TCCR1A / TCCR1B */
+#define COM1A1  7
+#define COM1A0  6
+#define COM1B1  5
+#define COM1B0  4
+#define FOC1A   3
+#define FOC1B   2
+#define WGM11   1
+#define WGM10   0
+#define ICNC1   7
+#define ICES1   6
+#define WGM13   4
+#define WGM12   3
+#define CS12    2
+#define CS11    1
+#define CS10    0
+
+/* TCCR2 */
+#define FOC2    7
+#define WGM20   6
+#define COM21   5
+#define COM20   4
+#define WGM21   3
+#define CS22    2
+#define CS21    1
+#define CS20    0
+
+/* ADMUX / ADCSRA */
+#define REFS1   7
+#define REFS0   6
+#define ADLAR   5
+#define MUX4    4
+#define MUX3    3
+#define MUX2    2
+#define MUX1    1
+#define MUX0    0
+#define ADEN    7
+#define ADSC    6
+#define ADATE   5
+#define ADIF    4
+#define ADIE    3
+#define ADPS2   2
+#define ADPS1   1
+#define ADPS0   0
+
+/* USART */
+#define RXC     7
+#define TXC     6
+#define UDRE    5
+#define FE      4
+#define DOR     3
+#define PE      2
+#define U2X     1
+#define MPCM    0
+#define RXCIE   7
+#define TXCIE   6
+#define UDRIE   5
+#define RXEN    4
+#define TXEN    3
+#define UCSZ2   2
+#define RXB8    1
+#define TXB8    0
+#define URSEL   7
+#define UMSEL   6
+#define UPM1    5
+#define UPM0    4
+#define USBS    3
+#define UCSZ1   2
+#define UCSZ0   1
+#define UCPOL   0
+
+/* TWI */
+#define TWINT   7
+#define TWEA    6
+#define TWSTA   5
+#define TWSTO   4
+#define TWWC    3
+#define TWEN    2
+#define TWIE    0
+
+/*******************************************************************************
+ *                           Interrupt vectors                                 *
+ *******************************************************************************/
+#define INT0_vect                      __vector_1
+#define INT1_vect                      __vector_2
+#define INT2_vect                      __vector_3
+#define TIMER2_COMP_vect               __vector_4
+#define TIMER2_OVF_vect                __vector_5
+#define TIMER1_CAPT_vect               __vector_6
+#define TIMER1_COMPA_vect              __vector_7
+#define TIMER1_COMPB_vect              __vector_8
+#define TIMER1_OVF_vect                __vector_9
+#define TIMER0_COMP_vect               __vector_10
+#define TIMER0_OVF_vect                __vector_11
+#define SPI_STC_vect                   __vector_12
+#define USART_RXC_vect                 __vector_13
+#define USART_UDRE_vect                __vector_14
+#define USART_TXC_vect                 __vector_15
+#define ADC_vect                       __vector_16
+#define EE_RDY_vect                    __vector_17
+#define ANA_COMP_vect                  __vector_18
+#define TWI_vect                       __vector_19
+#define SPM_RDY_vect                   __vector_20
+#define _VECTORS_SIZE                  84
+
+/*******************************************************************************
+ *                                 Misc                                        *
+ *******************************************************************************/
+#define RAMSTART                       0x60
+#define RAMEND                         0x85F
+#define _BV(bit)                       (1 << (bit))
+
+#endif /* HOST_AVR_IO_H_ */
@@ -0,0 +1,26 @@
+/*
+ * pgmspace.h
+ *
+ *  Host stand-in for <avr/pgmspace.h>, flash and RAM share one address space.
+ */
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s)                        (s)
+#define PGM_P                          const char *
+
+#define pgm_read_byte(addr)            (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)            (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)           (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr)             (*(void * const *)(addr))
+
+#define memcpy_P                       memcpy
+#define strlen_P                       strlen
+#define strcmp_P                       strcmp
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
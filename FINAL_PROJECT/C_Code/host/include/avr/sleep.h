@@ -0,0 +1,25 @@
+/*
+ * sleep.h
+ *
+ *  Host stand-in for <avr/sleep.h>, every mode sleeps until the next ISR.
+ */
+
+#ifndef HOST_AVR_SLEEP_H_
+#define HOST_AVR_SLEEP_H_
+
+#include "hal_host.h"
+
+#define SLEEP_MODE_IDLE                0
+#define SLEEP_MODE_ADC                 1
+#define SLEEP_MODE_PWR_DOWN            2
+#define SLEEP_MODE_PWR_SAVE            3
+#define SLEEP_MODE_STANDBY             6
+#define SLEEP_MODE_EXT_STANDBY         7
+
+#define set_sleep_mode(mode)           ((void)(mode))
+#define sleep_enable()                 ((void)0)
+#define sleep_disable()                ((void)0)
+#define sleep_cpu()                    HostHal_sleep()
+#define sleep_mode()                   HostHal_sleep()
+
+#endif /* HOST_AVR_SLEEP_H_ */
@@ -0,0 +1,26 @@
+/*
+ * atomic.h
+ *
+ *  Host stand-in for <util/atomic.h>, the block holds the interrupt lock of hal_host.c
+ *  (released by a cleanup handler, so leaving the block with return/break is fine as on the AVR).
+ */
+
+#ifndef HOST_UTIL_ATOMIC_H_
+#define HOST_UTIL_ATOMIC_H_
+
+#include <stdint.h>
+#include "hal_host.h"
+
+#define ATOMIC_RESTORESTATE            0
+#define ATOMIC_FORCEON                 1
+#define NONATOMIC_RESTORESTATE         0
+#define NONATOMIC_FORCEOFF             0
+
+#define ATOMIC_BLOCK(type) \
+	for(uint8_t host_irqState __attribute__((__cleanup__(HostHal_irqRelease))) = HostHal_irqAcquire(type), \
+	    host_irqToDo = 1; host_irqToDo; host_irqToDo = 0)
+
+/* Interrupts can't preempt the application more than they already do on the host */
+#define NONATOMIC_BLOCK(type)          for(uint8_t host_irqToDo = 1; host_irqToDo; host_irqToDo = 0)
+
+#endif /* HOST_UTIL_ATOMIC_H_ */
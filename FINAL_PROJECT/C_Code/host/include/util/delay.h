@@ -0,0 +1,19 @@
+/*
+ * delay.h
+ *
+ *  Host stand-in for <util/delay.h>, the delays wait on the virtual clock of hal_host.c.
+ */
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+#include "hal_host.h"
+
+#ifndef F_CPU
+#error "F_CPU must be defined"
+#endif
+
+#define _delay_ms(ms)                  HostHal_delayCycles((uint64_t)((ms) * (F_CPU / 1000.0)))
+#define _delay_us(us)                  HostHal_delayCycles((uint64_t)((us) * (F_CPU / 1000000.0)))
+
+#endif /* HOST_UTIL_DELAY_H_ */
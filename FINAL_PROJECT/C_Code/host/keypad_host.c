@@ -0,0 +1,175 @@
+/*
+ * keypad_host.c
+ *
+ *  Host backend of the keypad driver, the keys are characters read from a file descriptor
+ *  by a reader thread and queued as a press followed by a release.
+ *
+ *  DOORLOCK_KEYPAD_FD : descriptor the keys are read from (default stdin).
+ *  '0'..'9' are the digits, '+' '-' '*' '%' '=' are themselves and 'c' is the Enter key (13),
+ *  'L' makes the next key a long press (press, long press, release), any other character is ignored. The ECU exits once the input ended and the queue is empty.
+ */
+
+#include "cpu_load.h"
+#include "keypad.h"
+#include "latency.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static KEYPAD_Event g_eventQueue[KEYPAD_EVENT_QUEUE_SIZE];
+static uint8 g_eventHead = 0;
+static uint8 g_eventTail = 0;
+static uint8 g_inputEnded = FALSE;
+static pthread_mutex_t g_keypadLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_keypadCond = PTHREAD_COND_INITIALIZER;
+
+/* Key value of a character, KEYPAD_NO_KEY if it is not on the keypad */
+static uint8 KEYPAD_keyOf(char character)
+{
+	switch(character)
+	{
+	case '+': case '-': case '*': case '%': case '=':
+		return (uint8)character;
+	case 'c':
+		return 13;
+	default:
+		if((character >= '0') && (character <= '9'))
+		{
+			return (uint8)(character - '0');
+		}
+		return KEYPAD_NO_KEY;
+	}
+}
+
+/* Called with g_keypadLock held, waits for room as the keys come faster than they are read */
+static void KEYPAD_pushEvent(uint8 key, KEYPAD_EventType type)
+{
+	uint8 next = (g_eventHead + 1) & (KEYPAD_EVENT_QUEUE_SIZE - 1);
+
+	while(next == g_eventTail)
+	{
+		pthread_cond_wait(&g_keypadCond, &g_keypadLock);
+	}
+	g_eventQueue[g_eventHead].key = key;
+	g_eventQueue[g_eventHead].type = type;
+	g_eventHead = next;
+	pthread_cond_broadcast(&g_keypadCond);
+}
+
+static void *KEYPAD_reader(void *arg)
+{
+	int fd = *(int *)arg;
+	char character;
+	uint8 key, longPress = FALSE;
+
+	while(read(fd, &character, 1) == 1)
+	{
+		if(character == 'L')
+		{
+			longPress = TRUE;
+			continue;
+		}
+		key = KEYPAD_keyOf(character);
+		if(key == KEYPAD_NO_KEY)
+		{
+			continue;
+		}
+		pthread_mutex_lock(&g_keypadLock);
+		KEYPAD_pushEvent(key, KEYPAD_PRESS);
+		if(longPress)
+		{
+			KEYPAD_pushEvent(key, KEYPAD_LONG_PRESS);
+			longPress = FALSE;
+		}
+		KEYPAD_pushEvent(key, KEYPAD_RELEASE);
+		pthread_mutex_unlock(&g_keypadLock);
+	}
+
+	pthread_mutex_lock(&g_keypadLock);
+	g_inputEnded = TRUE;
+	pthread_cond_broadcast(&g_keypadCond);
+	pthread_mutex_unlock(&g_keypadLock);
+	return NULL;
+}
+
+void KEYPAD_init(void)
+{
+	static int fd = STDIN_FILENO;
+	const char *env = getenv("DOORLOCK_KEYPAD_FD");
+	pthread_t thread;
+
+	if(env != NULL)
+	{
+		fd = atoi(env);
+	}
+	if(pthread_create(&thread, NULL, KEYPAD_reader, &fd) == 0)
+	{
+		pthread_detach(thread);
+	}
+}
+
+void KEYPAD_scanTick(void)
+{
+	/* Nothing to scan, the reader thread queues the events */
+}
+
+uint8 KEYPAD_getEvent(KEYPAD_Event *event)
+{
+	uint8 found = FALSE;
+
+	pthread_mutex_lock(&g_keypadLock);
+	if(g_eventTail != g_eventHead)
+	{
+		*event = g_eventQueue[g_eventTail];
+		g_eventTail = (g_eventTail + 1) & (KEYPAD_EVENT_QUEUE_SIZE - 1);
+		pthread_cond_broadcast(&g_keypadCond);
+		found = TRUE;
+	}
+	pthread_mutex_unlock(&g_keypadLock);
+	return found;
+}
+
+/* Take the oldest key event, waiting for one, the ECU exits once the input ended */
+static void KEYPAD_waitEvent(KEYPAD_Event *event)
+{
+	while(!KEYPAD_getEvent(event))
+	{
+		CpuLoad_idleBegin();
+		pthread_mutex_lock(&g_keypadLock);
+		while((g_eventTail == g_eventHead) && !g_inputEnded)
+		{
+			pthread_cond_wait(&g_keypadCond, &g_keypadLock);
+		}
+		if((g_eventTail == g_eventHead) && g_inputEnded)
+		{
+			pthread_mutex_unlock(&g_keypadLock);
+			exit(EXIT_SUCCESS);
+		}
+		pthread_mutex_unlock(&g_keypadLock);
+		CpuLoad_idleEnd();
+	}
+}
+
+uint8 KEYPAD_getPressedKey(void)
+{
+	KEYPAD_Event event;
+
+	do
+	{
+		KEYPAD_waitEvent(&event);
+	} while(event.type != KEYPAD_PRESS);
+	Latency_start(LATENCY_KEY_ECHO);
+	return event.key;
+}
+
+uint8 KEYPAD_isLongPress(uint8 key)
+{
+	KEYPAD_Event event;
+
+	do
+	{
+		KEYPAD_waitEvent(&event);
+	} while((event.key != key) || (event.type == KEYPAD_PRESS));
+	return (event.type == KEYPAD_LONG_PRESS);
+}
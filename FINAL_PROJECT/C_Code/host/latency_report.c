@@ -0,0 +1,211 @@
+/*
+ * latency_report.c
+ *
+ *  Prints the latency histograms dumped by the ECUs (see latency.h).
+ *
+ *  usage: latency-report [capture-file]
+ *    reads the bytes captured on the link (default stdin), finds every frame by its start byte
+ *    and checksum, and prints per histogram the number of operations, the p50, p90 and p99
+ *    (upper bound of the bucket they fall in, '-' when in the last open bucket) and the buckets.
+ *    The other bytes of the capture (the normal link traffic) are ignored.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "latency.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define REPORT_COUNT_MS                (1024.0 * 1000.0 / F_CPU)   /* One Timer1 count (F_CPU/1024) */
+#define REPORT_MAX_BUCKETS             32
+
+/*******************************************************************************
+ *                           Private Variables                                 *
+ *******************************************************************************/
+#define REPORT_NAME_ENTRY(ID, NAME, ECU)   [ID] = NAME,
+static const char *const g_names[LATENCY_NUM_OF_HISTOGRAMS] =
+{
+	LATENCY_HISTOGRAMS(REPORT_NAME_ENTRY)
+};
+#undef REPORT_NAME_ENTRY
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+/* Size of the frame starting at data[0] when it is complete and its checksum is right, else 0 */
+static size_t Report_frameSize(const uint8_t *data, size_t length)
+{
+	size_t size, index;
+	uint8_t checksum = 0;
+
+	if(length < 1 + LATENCY_FRAME_HEADER_SIZE + 1)
+	{
+		return 0;
+	}
+	if((data[3] == 0) || (data[3] > REPORT_MAX_BUCKETS))
+	{
+		return 0;
+	}
+	size = 1 + LATENCY_FRAME_HEADER_SIZE + (size_t)data[2] * (1 + 2 * (size_t)data[3]) + 1;
+	if(length < size)
+	{
+		return 0;
+	}
+	for(index = 1 ; index < size - 1 ; index++)
+	{
+		checksum += data[index];
+	}
+	return (checksum == data[size - 1]) ? size : 0;
+}
+
+/* Time in ms every latency of a bucket is below (bucket b holds up to 2^b - 1 whole counts) */
+static double Report_bucketLimit(unsigned bucket)
+{
+	return (double)(1UL << bucket) * REPORT_COUNT_MS;
+}
+
+/* Upper bound of the bucket holding the given fraction of the operations */
+static void Report_percentile(const unsigned *counters, unsigned buckets, unsigned long total, double fraction)
+{
+	unsigned long seen = 0;
+	unsigned bucket;
+
+	for(bucket = 0 ; bucket < buckets ; bucket++)
+	{
+		seen += counters[bucket];
+		if((double)seen >= fraction * (double)total)
+		{
+			break;
+		}
+	}
+	if(bucket >= buckets - 1)
+	{
+		printf(" %9s", "-");
+		return;
+	}
+	printf(" %9.3f", Report_bucketLimit(bucket));
+}
+
+static void Report_frame(const uint8_t *frame)
+{
+	const uint8_t *histogram = frame + 1 + LATENCY_FRAME_HEADER_SIZE;
+	unsigned count = frame[2], buckets = frame[3], index, bucket;
+	unsigned counters[REPORT_MAX_BUCKETS];
+	unsigned long total;
+	char unknown[16];
+	const char *name;
+
+	printf("# ECU %c: %u histograms of %u log2 buckets (ms)\n", frame[1], count, buckets);
+	printf("%-14s %8s %9s %9s %9s\n", "latency", "count", "p50 <", "p90 <", "p99 <");
+
+	for(index = 0 ; index < count ; index++, histogram += 1 + 2 * buckets)
+	{
+		total = 0;
+		for(bucket = 0 ; bucket < buckets ; bucket++)
+		{
+			counters[bucket] = histogram[1 + 2 * bucket] | (histogram[2 + 2 * bucket] << 8);
+			total += counters[bucket];
+		}
+		if(histogram[0] < LATENCY_NUM_OF_HISTOGRAMS)
+		{
+			name = g_names[histogram[0]];
+		}
+		else
+		{
+			snprintf(unknown, sizeof(unknown), "latency-%u", histogram[0]);
+			name = unknown;
+		}
+
+		printf("%-14s %8lu", name, total);
+		if(total != 0)
+		{
+			Report_percentile(counters, buckets, total, 0.50);
+			Report_percentile(counters, buckets, total, 0.90);
+			Report_percentile(counters, buckets, total, 0.99);
+		}
+		printf("\n");
+
+		for(bucket = 0 ; bucket < buckets ; bucket++)
+		{
+			if(counters[bucket] == 0)
+			{
+				continue;
+			}
+			if(bucket == buckets - 1)
+			{
+				printf("   >= %9.3f ms  %u\n", Report_bucketLimit(bucket - 1), counters[bucket]);
+			}
+			else
+			{
+				printf("    < %9.3f ms  %u\n", Report_bucketLimit(bucket), counters[bucket]);
+			}
+		}
+	}
+}
+
+/*******************************************************************************
+ *                                 Main                                        *
+ *******************************************************************************/
+int main(int argc, char **argv)
+{
+	FILE *input = stdin;
+	uint8_t *data = NULL;
+	size_t length = 0, capacity = 0, offset = 0, size;
+	unsigned frames = 0;
+
+	if(argc > 2)
+	{
+		fprintf(stderr, "usage: %s [capture-file]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	if((argc == 2) && ((input = fopen(argv[1], "rb")) == NULL))
+	{
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	for(;;)
+	{
+		if(length == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 4096;
+			if((data = realloc(data, capacity)) == NULL)
+			{
+				perror("realloc");
+				return EXIT_FAILURE;
+			}
+		}
+		size = fread(data + length, 1, capacity - length, input);
+		if(size == 0)
+		{
+			break;
+		}
+		length += size;
+	}
+
+	while(offset < length)
+	{
+		if((data[offset] == LATENCY_FRAME_START) && ((size = Report_frameSize(data + offset, length - offset)) != 0))
+		{
+			Report_frame(data + offset);
+			offset += size;
+			frames++;
+		}
+		else
+		{
+			offset++;
+		}
+	}
+
+	free(data);
+	if(frames == 0)
+	{
+		fprintf(stderr, "no latency frame found\n");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+/*
+ * plant_host.c
+ *
+ *  Model of what is wired to the Control ECU on the host: the door with its DC motor, encoder,
+ *  end stop switches and current shunt, and the PIR sensor. Runs on every step of the model thread.
+ *
+ *  DOORLOCK_PLANT_FD : descriptor for the commands below (one per line) and the door events.
+ *  Commands: "pir 1" / "pir 0"        someone in front of the door / nobody
+ *            "obstacle N" / "obstacle off"  something blocks the door at position N while it closes
+ *            "sensors 0" / "sensors 1"      encoder, end stop switches and shunt not wired (stock schematic) / wired
+ *  Events:   "<seconds> door closed|open|moving"  written when an end stop is reached or left
+ */
+
+#include "door_position.h"
+#include "gpio.h"
+#include "hal_host.h"
+#include "motor.h"
+#include "PIR.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PLANT_STEP_SECONDS             ((double)HOST_HAL_STEP_CYCLES / F_CPU)
+#define PLANT_MAX_SPEED                400.0    /* Counts per second at full duty without load */
+#define PLANT_LOAD_FACTOR              0.9      /* Running speed under the door load */
+#define PLANT_DRIVE_TAU                0.05     /* Seconds, speed settling while driven */
+#define PLANT_BRAKE_TAU                0.01     /* Seconds, speed settling while braking */
+#define PLANT_COAST_TAU                0.3      /* Seconds, speed settling while coasting */
+#define PLANT_CURRENT_GAIN             600.0    /* ADC counts per unit of (voltage - back EMF) */
+#define PLANT_CURRENT_CHANNEL          1        /* Shunt on ADC1 */
+#define PLANT_SWITCH_MARGIN            3.0      /* Counts, a switch is pressed this close to its mechanical end */
+#define PLANT_NO_OBSTACLE              (-1000.0)
+
+typedef enum
+{
+	PLANT_DOOR_CLOSED, PLANT_DOOR_OPEN, PLANT_DOOR_MOVING
+} Plant_DoorType;
+
+static const char *const g_doorNames[] = {"closed", "open", "moving"};
+
+static double g_position = DOOR_POSITION_CLOSED;   /* Counts */
+static double g_speed = 0.0;                       /* Counts per second, positive = opening */
+static volatile double g_obstacle = PLANT_NO_OBSTACLE;
+static volatile uint8 g_pirLevel = LOGIC_LOW;
+static volatile uint8 g_sensors = TRUE;             /* Encoder, end stop switches and shunt wired */
+static uint8 g_encoderHigh = FALSE;
+static Plant_DoorType g_door = PLANT_DOOR_CLOSED;
+static uint8 g_pinLevels[3] = {0xFF, 0xFF, 0xFF};   /* Closed switch, open switch, PIR as last driven */
+static FILE *g_events = NULL;
+
+/* Drive a pin only when its level changes, every drive recomputes the ports */
+static void Plant_drive(uint8 index, uint8 port, uint8 pin, uint8 level)
+{
+	if(g_pinLevels[index] != level)
+	{
+		HostHal_setPin(port, pin, level);
+		g_pinLevels[index] = level;
+	}
+}
+
+/* Duty cycle on the enable pin (fast PWM on OC0, non-inverting while COM01 is set) */
+static double Plant_duty(void)
+{
+	if(!(TCCR0 & (1 << COM01)))
+	{
+		return 0.0;
+	}
+	return (OCR0 + 1) / 256.0;
+}
+
+static void Plant_step(void)
+{
+	uint8 in1 = HostHal_getPin(MOTOR_IN1_PORT_ID, MOTOR_IN1_PIN_ID);
+	uint8 in2 = HostHal_getPin(MOTOR_IN2_PORT_ID, MOTOR_IN2_PIN_ID);
+	double duty = Plant_duty();
+	double voltage = 0.0, target = 0.0, tau = PLANT_COAST_TAU, current = 0.0;
+	double previous = g_position;
+	Plant_DoorType door;
+
+	/* H-bridge: IN2 alone opens (CW), IN1 alone closes (A_CW), both brake, none coasts */
+	if(in1 != in2)
+	{
+		voltage = in2 ? duty : -duty;
+		target = voltage * PLANT_MAX_SPEED * PLANT_LOAD_FACTOR;
+		tau = PLANT_DRIVE_TAU;
+	}
+	else if(in1 && in2)
+	{
+		tau = PLANT_BRAKE_TAU;
+	}
+
+	g_speed += (target - g_speed) * (PLANT_STEP_SECONDS / tau);
+	g_position += g_speed * PLANT_STEP_SECONDS;
+
+	/* Mechanical limits and the obstacle stop the door dead */
+	if(g_position < DOOR_POSITION_CLOSED)
+	{
+		g_position = DOOR_POSITION_CLOSED;
+		g_speed = 0.0;
+	}
+	else if(g_position > DOOR_POSITION_OPEN)
+	{
+		g_position = DOOR_POSITION_OPEN;
+		g_speed = 0.0;
+	}
+	if((previous >= g_obstacle) && (g_position < g_obstacle))
+	{
+		g_position = g_obstacle;
+		g_speed = 0.0;
+	}
+
+	/* Shunt current from the voltage left after the back EMF */
+	if(g_sensors && (in1 != in2))
+	{
+		current = PLANT_CURRENT_GAIN * (voltage - g_speed / PLANT_MAX_SPEED);
+		current = (current < 0) ? -current : current;
+		current = (current > 1023.0) ? 1023.0 : current;
+	}
+	HostHal_setAnalog(PLANT_CURRENT_CHANNEL, (uint16_t)current);
+
+	/* One encoder pulse per count (high for one step), counts are centred on the integer positions */
+	if(g_encoderHigh)
+	{
+		HostHal_setPin(DOOR_ENCODER_PORT_ID, DOOR_ENCODER_PIN_ID, LOGIC_LOW);
+		g_encoderHigh = FALSE;
+	}
+	else if(g_sensors && ((long)(g_position + 0.5) != (long)(previous + 0.5)))
+	{
+		HostHal_setPin(DOOR_ENCODER_PORT_ID, DOOR_ENCODER_PIN_ID, LOGIC_HIGH);
+		g_encoderHigh = TRUE;
+	}
+
+	/* Active low end stop switches, left on their pull-ups when not wired */
+	Plant_drive(0, DOOR_CLOSED_SWITCH_PORT_ID, DOOR_CLOSED_SWITCH_PIN_ID,
+			(g_sensors && (g_position <= DOOR_POSITION_CLOSED + PLANT_SWITCH_MARGIN)) ? LOGIC_LOW : LOGIC_HIGH);
+	Plant_drive(1, DOOR_OPEN_SWITCH_PORT_ID, DOOR_OPEN_SWITCH_PIN_ID,
+			(g_sensors && (g_position >= DOOR_POSITION_OPEN - PLANT_SWITCH_MARGIN)) ? LOGIC_LOW : LOGIC_HIGH);
+
+	Plant_drive(2, PIR_PORT, PIR_PIN, g_pirLevel);
+
+	door = (g_position <= DOOR_POSITION_CLOSED + PLANT_SWITCH_MARGIN) ? PLANT_DOOR_CLOSED :
+	       (g_position >= DOOR_POSITION_OPEN - PLANT_SWITCH_MARGIN) ? PLANT_DOOR_OPEN : PLANT_DOOR_MOVING;
+	if((door != g_door) && (g_events != NULL))
+	{
+		fprintf(g_events, "%.6f door %s\n", (double)HostHal_cycles() / F_CPU, g_doorNames[door]);
+		fflush(g_events);
+	}
+	g_door = door;
+}
+
+static void *Plant_reader(void *arg)
+{
+	FILE *commands = arg;
+	char line[64], name[16], value[16];
+
+	while(fgets(line, sizeof(line), commands) != NULL)
+	{
+		if(sscanf(line, "%15s %15s", name, value) != 2)
+		{
+			continue;
+		}
+		if(strcmp(name, "pir") == 0)
+		{
+			g_pirLevel = (atoi(value) != 0) ? LOGIC_HIGH : LOGIC_LOW;
+		}
+		else if(strcmp(name, "obstacle") == 0)
+		{
+			g_obstacle = (strcmp(value, "off") == 0) ? PLANT_NO_OBSTACLE : atof(value);
+		}
+		else if(strcmp(name, "sensors") == 0)
+		{
+			g_sensors = (atoi(value) != 0);
+		}
+	}
+	return NULL;
+}
+
+__attribute__((constructor)) static void Plant_init(void)
+{
+	const char *env = getenv("DOORLOCK_PLANT_FD");
+	pthread_t thread;
+	int fd;
+
+	if(env != NULL)
+	{
+		fd = atoi(env);
+		g_events = fdopen(fd, "w");
+		if(pthread_create(&thread, NULL, Plant_reader, fdopen(dup(fd), "r")) == 0)
+		{
+			pthread_detach(thread);
+		}
+	}
+	HostHal_setStepHook(Plant_step);
+}
@@ -0,0 +1,47 @@
+/*
+ * stack_monitor_host.c
+ *
+ *  Host backend of the stack monitor: there is no ATmega32 RAM to paint, the dump frame is sent
+ *  with every size 0 so the link and the tools behave as on the boards (see stack_monitor.h).
+ */
+
+#include "stack_monitor.h"
+#include "ecu_config.h"
+#include "UART.h"
+
+void StackMonitor_init(void)
+{
+}
+
+void StackMonitor_check(void)
+{
+}
+
+uint16 StackMonitor_unused(void)
+{
+	return 0;
+}
+
+void StackMonitor_dump(void)
+{
+	uint8 index;
+
+	UART_sendByte(STACKMON_FRAME_START);
+	UART_sendByte(ECU_ID);
+	for(index = 1 ; index < STACKMON_FRAME_SIZE ; index++)
+	{
+		UART_sendByte(0);
+	}
+	UART_sendByte(ECU_ID);        /* Checksum */
+}
+
+void StackMonitor_skipFrame(void)
+{
+	uint8 left = STACKMON_FRAME_SIZE + 1;
+
+	while(left != 0)
+	{
+		(void)UART_recieveByte();
+		left--;
+	}
+}
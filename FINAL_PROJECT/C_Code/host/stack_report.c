@@ -0,0 +1,125 @@
+/*
+ * stack_report.c
+ *
+ *  Prints the RAM figures dumped by the ECUs (see stack_monitor.h).
+ *
+ *  usage: stack-report [capture-file]
+ *    reads the bytes captured on the link (default stdin), finds every frame by its start byte
+ *    and checksum, and prints the RAM taken by the variables, the room left for the stack and
+ *    how much of it was never used. The other bytes of the capture are ignored.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "stack_monitor.h"
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+/* Size of the frame starting at data[0] when it is complete and its checksum is right, else 0 */
+static size_t Report_frameSize(const uint8_t *data, size_t length)
+{
+	size_t size = 1 + STACKMON_FRAME_SIZE + 1, index;
+	uint8_t checksum = 0;
+
+	if(length < size)
+	{
+		return 0;
+	}
+	for(index = 1 ; index < size - 1 ; index++)
+	{
+		checksum += data[index];
+	}
+	return (checksum == data[size - 1]) ? size : 0;
+}
+
+static unsigned Report_get16(const uint8_t *data)
+{
+	return data[0] | (data[1] << 8);
+}
+
+static void Report_frame(const uint8_t *frame)
+{
+	unsigned ram = Report_get16(frame + 2);
+	unsigned variables = Report_get16(frame + 4);
+	unsigned room = Report_get16(frame + 6);
+	unsigned unused = Report_get16(frame + 8);
+
+	printf("# ECU %c\n", frame[1]);
+	if(ram == 0)
+	{
+		printf("not measured (host build)\n");
+		return;
+	}
+	printf("%-22s %6u bytes\n", "RAM", ram);
+	printf("%-22s %6u bytes  %5.1f%%\n", "variables", variables, 100.0 * variables / ram);
+	printf("%-22s %6u bytes  %5.1f%%\n", "stack room at boot", room, 100.0 * room / ram);
+	printf("%-22s %6u bytes  %5.1f%%\n", "stack used (peak)", room - unused, 100.0 * (room - unused) / ram);
+	printf("%-22s %6u bytes  %5.1f%%\n", "never used", unused, 100.0 * unused / ram);
+}
+
+/*******************************************************************************
+ *                                 Main                                        *
+ *******************************************************************************/
+int main(int argc, char **argv)
+{
+	FILE *input = stdin;
+	uint8_t *data = NULL;
+	size_t length = 0, capacity = 0, offset = 0, size;
+	unsigned frames = 0;
+
+	if(argc > 2)
+	{
+		fprintf(stderr, "usage: %s [capture-file]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	if((argc == 2) && ((input = fopen(argv[1], "rb")) == NULL))
+	{
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	for(;;)
+	{
+		if(length == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 4096;
+			if((data = realloc(data, capacity)) == NULL)
+			{
+				perror("realloc");
+				return EXIT_FAILURE;
+			}
+		}
+		size = fread(data + length, 1, capacity - length, input);
+		if(size == 0)
+		{
+			break;
+		}
+		length += size;
+	}
+
+	while(offset < length)
+	{
+		if((data[offset] == STACKMON_FRAME_START) && ((size = Report_frameSize(data + offset, length - offset)) != 0))
+		{
+			Report_frame(data + offset);
+			offset += size;
+			frames++;
+		}
+		else
+		{
+			offset++;
+		}
+	}
+
+	free(data);
+	if(frames == 0)
+	{
+		fprintf(stderr, "no stack frame found\n");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,201 @@
+/*
+ * trace_decode.c
+ *
+ *  Turns the trace frames dumped by the ECUs (see trace.h) into a timeline.
+ *
+ *  usage: trace-decode [capture-file]
+ *    reads the bytes captured on the link (default stdin), finds every frame by its start byte
+ *    and checksum, and prints one line per record:
+ *      <ms since the first record>  <ECU>  <event>  <arg>  [span: <ms since its begin event>]
+ *    the other bytes of the capture (the normal link traffic) are ignored.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trace.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define DECODE_TICK_MS                 (1024.0 * 1000.0 / F_CPU)   /* One Timer1 count (F_CPU/1024) */
+#define DECODE_RECORD_SIZE             4
+
+typedef struct
+{
+	const char *name;
+	uint8_t begin;
+} Decode_EventType;
+
+/*******************************************************************************
+ *                           Private Variables                                 *
+ *******************************************************************************/
+#define DECODE_EVENT_ENTRY(ID, NAME, BEGIN)   [ID] = {NAME, BEGIN},
+static const Decode_EventType g_events[TRACE_NUM_OF_EVENTS] =
+{
+	TRACE_EVENTS(DECODE_EVENT_ENTRY)
+};
+#undef DECODE_EVENT_ENTRY
+
+/*******************************************************************************
+ *                          Private Functions                                  *
+ *******************************************************************************/
+
+/* Size of the frame starting at data[0] when it is complete and its checksum is right, else 0 */
+static size_t Decode_frameSize(const uint8_t *data, size_t length)
+{
+	size_t size, index;
+	uint8_t checksum = 0;
+
+	if(length < 1 + TRACE_FRAME_HEADER_SIZE + 1)
+	{
+		return 0;
+	}
+	size = 1 + TRACE_FRAME_HEADER_SIZE + (size_t)data[2] * DECODE_RECORD_SIZE + 1;
+	if(length < size)
+	{
+		return 0;
+	}
+	for(index = 1 ; index < size - 1 ; index++)
+	{
+		checksum += data[index];
+	}
+	return (checksum == data[size - 1]) ? size : 0;
+}
+
+static void Decode_frame(const uint8_t *frame)
+{
+	const uint8_t *record = frame + 1 + TRACE_FRAME_HEADER_SIZE;
+	uint8_t ecu = frame[1], count = frame[2], lost = frame[3];
+	uint32_t period = (uint32_t)(frame[4] | (frame[5] << 8)) + 1;
+	uint64_t periods = 0, time = 0, first = 0, begins[TRACE_NUM_OF_EVENTS];
+	uint8_t seen[TRACE_NUM_OF_EVENTS] = {0}, started = 0;
+	uint32_t owed = 0, stamp, previous = 0;
+	uint8_t id, arg, index;
+	char unknown[16];
+	const char *name;
+
+	printf("# ECU %c: %u records, %u lost before them, %.3f ms per Timer1 period\n",
+			ecu, count, lost, period * DECODE_TICK_MS);
+
+	for(index = 0 ; index < count ; index++, record += DECODE_RECORD_SIZE)
+	{
+		id = record[0];
+		arg = record[1];
+		stamp = (uint32_t)(record[2] | (record[3] << 8));
+
+		if(id == TRACE_WRAP)
+		{
+			/* A period already counted from a stamp going back is not counted twice */
+			if(arg > owed)
+			{
+				periods += arg - owed;
+				owed = 0;
+			}
+			else
+			{
+				owed -= arg;
+			}
+			continue;
+		}
+		if((index != 0) && (stamp < previous) && (record[-DECODE_RECORD_SIZE] != TRACE_WRAP))
+		{
+			/* Timer1 went round while its interrupt was held off */
+			periods++;
+			owed++;
+		}
+		previous = stamp;
+		time = periods * period + stamp;
+		if(!started)
+		{
+			first = time;
+			started = 1;
+		}
+
+		if(id < TRACE_NUM_OF_EVENTS)
+		{
+			name = g_events[id].name;
+		}
+		else
+		{
+			snprintf(unknown, sizeof(unknown), "event-%u", id);
+			name = unknown;
+		}
+		printf("%10.3f  %c  %-14s %3u", (time - first) * DECODE_TICK_MS, ecu, name, arg);
+		if((id < TRACE_NUM_OF_EVENTS) && (g_events[id].begin != TRACE_NO_BEGIN) && seen[g_events[id].begin])
+		{
+			printf("  span %.3f ms", (time - begins[g_events[id].begin]) * DECODE_TICK_MS);
+			seen[g_events[id].begin] = 0;
+		}
+		if(id < TRACE_NUM_OF_EVENTS)
+		{
+			begins[id] = time;
+			seen[id] = 1;
+		}
+		printf("\n");
+	}
+}
+
+/*******************************************************************************
+ *                                 Main                                        *
+ *******************************************************************************/
+int main(int argc, char **argv)
+{
+	FILE *input = stdin;
+	uint8_t *data = NULL;
+	size_t length = 0, capacity = 0, offset = 0, size;
+	unsigned frames = 0;
+
+	if(argc > 2)
+	{
+		fprintf(stderr, "usage: %s [capture-file]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	if((argc == 2) && ((input = fopen(argv[1], "rb")) == NULL))
+	{
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	for(;;)
+	{
+		if(length == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 4096;
+			if((data = realloc(data, capacity)) == NULL)
+			{
+				perror("realloc");
+				return EXIT_FAILURE;
+			}
+		}
+		size = fread(data + length, 1, capacity - length, input);
+		if(size == 0)
+		{
+			break;
+		}
+		length += size;
+	}
+
+	while(offset < length)
+	{
+		if((data[offset] == TRACE_FRAME_START) && ((size = Decode_frameSize(data + offset, length - offset)) != 0))
+		{
+			Decode_frame(data + offset);
+			offset += size;
+			frames++;
+		}
+		else
+		{
+			offset++;
+		}
+	}
+
+	free(data);
+	if(frames == 0)
+	{
+		fprintf(stderr, "no trace frame found\n");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
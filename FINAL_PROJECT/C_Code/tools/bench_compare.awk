@@ -0,0 +1,73 @@
+#
+# bench_compare.awk
+#
+#  Cycles of every benchmark case side by side, from several bench_results.json written by
+#  simavr-bench (../bench). The first file is the reference, the others also get their speed-up.
+#  A column is named after the directory holding its file (Debug, Release-Size, ...).
+#
+#  usage: awk -f bench_compare.awk Debug/bench_results.json Release-Size/bench_results.json ...
+#
+
+# Value of a "key": value pair on the line, without the quotes of a string
+function field(line, key,    start, rest)
+{
+	start = index(line, "\"" key "\": ")
+	if(start == 0)
+	{
+		return ""
+	}
+	rest = substr(line, start + length(key) + 4)
+	sub(/[,}].*$/, "", rest)
+	gsub(/"/, "", rest)
+	return rest
+}
+
+FNR == 1 {
+	column = FILENAME
+	sub(/\/[^\/]*$/, "", column)
+	sub(/^.*\//, "", column)
+	columns[++columnCount] = column
+}
+
+/"firmware":/ { firmware = field($0, "firmware") }
+
+/"name":/ {
+	key = firmware " " field($0, "name")
+	if(!(key in seen))
+	{
+		seen[key] = 1
+		keys[++keyCount] = key
+	}
+	cycles[key, columnCount] = field($0, "cycles")
+}
+
+END {
+	printf("%-38s", "case (cycles)")
+	for(column = 1 ; column <= columnCount ; column++)
+	{
+		printf(" %14s", columns[column])
+	}
+	printf("\n")
+
+	for(index_ = 1 ; index_ <= keyCount ; index_++)
+	{
+		key = keys[index_]
+		printf("%-38s", key)
+		for(column = 1 ; column <= columnCount ; column++)
+		{
+			if(!((key, column) in cycles))
+			{
+				printf(" %14s", "-")
+			}
+			else if(column == 1 || cycles[key, 1] == "" || cycles[key, column] == 0)
+			{
+				printf(" %14d", cycles[key, column])
+			}
+			else
+			{
+				printf(" %8d %4.1fx", cycles[key, column], cycles[key, 1] / cycles[key, column])
+			}
+		}
+		printf("\n")
+	}
+}
@@ -0,0 +1,118 @@
+#
+# ram_report.awk
+#
+#  RAM use of an AVR image from its GNU ld map file (avr-gcc -Wl,-Map,<name>.map):
+#  size of .data (constants not placed in flash included), .bss and .noinit, the room left for
+#  the stack, then the bytes taken per object file and the largest variables.
+#
+#  usage: awk -v ram_size=2048 -f ram_report.awk <name>.map
+#
+#  The variables are named after their input section, the build uses -fdata-sections so every
+#  variable has its own (.bss.<name>, .data.<name>, static locals get a .<number> suffix).
+#
+
+function hex(text,    value, index_, digit)
+{
+	value = 0
+	text = tolower(text)
+	sub(/^0x/, "", text)
+	for(index_ = 1 ; index_ <= length(text) ; index_++)
+	{
+		digit = index("0123456789abcdef", substr(text, index_, 1)) - 1
+		value = value * 16 + digit
+	}
+	return value
+}
+
+function add(name, size, file)
+{
+	if(size == 0)
+	{
+		return
+	}
+	sub(/^.*[\/\\]/, "", file)
+	perFile[file] += size
+	if(name ~ /^\.(data|bss|noinit|rodata)\./)
+	{
+		sub(/^\.[a-z]+\./, "", name)
+	}
+	else
+	{
+		name = name " (" file ")"
+	}
+	if(section == ".data" && pending_rodata)
+	{
+		rodata += size
+		name = name " [const]"
+	}
+	variables[++count] = sprintf("%6d  %-6s %s", size, section, name)
+}
+
+BEGIN {
+	if(ram_size == "")
+	{
+		ram_size = 2048
+	}
+	section = ""
+}
+
+{ sub(/\r$/, "") }
+
+# Output section: .data, .bss, .noinit are in RAM, any other one ends the RAM part
+/^\.[A-Za-z_]/ {
+	section = ($1 ~ /^\.(data|bss|noinit)$/) ? $1 : ""
+	if(section != "" && NF >= 3)
+	{
+		total[section] = hex($3)
+	}
+	pending = ""
+	next
+}
+
+section == "" { next }
+
+# Input section alone on its line, its address, size and file follow on the next one
+/^ [.A-Z]/ && NF == 1 {
+	pending = $1
+	pending_rodata = (pending ~ /^\.rodata/)
+	next
+}
+
+# Input section with its address, size and file
+/^ [.A-Z]/ && NF >= 4 && $2 ~ /^0x/ {
+	pending_rodata = ($1 ~ /^\.rodata/)
+	add($1, hex($3), $4)
+	pending = ""
+	next
+}
+
+# Address, size and file of the input section named on the line before
+pending != "" && NF >= 3 && $1 ~ /^0x/ && $2 ~ /^0x/ {
+	add(pending, hex($2), $3)
+	pending = ""
+	next
+}
+
+END {
+	used = total[".data"] + total[".bss"] + total[".noinit"]
+	printf("RAM %d bytes\n", ram_size)
+	printf("  %-8s %6d  (%d of constants)\n", ".data", total[".data"], rodata)
+	printf("  %-8s %6d\n", ".bss", total[".bss"])
+	printf("  %-8s %6d\n", ".noinit", total[".noinit"])
+	printf("  %-8s %6d  %5.1f%%\n", "static", used, 100.0 * used / ram_size)
+	printf("  %-8s %6d  %5.1f%%  stack and interrupts\n", "left", ram_size - used, 100.0 * (ram_size - used) / ram_size)
+
+	printf("\nper object file\n")
+	for(file in perFile)
+	{
+		printf("%6d  %s\n", perFile[file], file) | "sort -rn"
+	}
+	close("sort -rn")
+
+	printf("\nlargest variables\n")
+	for(index_ = 1 ; index_ <= count ; index_++)
+	{
+		print variables[index_] | "sort -rn | head -20"
+	}
+	close("sort -rn | head -20")
+}